@@ -0,0 +1,540 @@
+// helpers/protopirate_archive.c
+#include "protopirate_archive.h"
+#include "protopirate_storage.h"
+#include <toolbox/stream/stream.h>
+#include <m-array.h>
+
+#define TAG "ProtoPirateArchive"
+
+#define PROTOPIRATE_ARCHIVE_MAGIC "PPAR"
+#define PROTOPIRATE_ARCHIVE_INDEX_MAGIC "PPIX"
+#define PROTOPIRATE_ARCHIVE_VERSION 1
+#define PROTOPIRATE_ARCHIVE_HEADER_SIZE 8
+#define PROTOPIRATE_ARCHIVE_FOOTER_SIZE 12
+#define PROTOPIRATE_ARCHIVE_CHUNK_SIZE 256
+// Far above any serialized capture, bounds recovery of a torn archive
+#define PROTOPIRATE_ARCHIVE_RECORD_MAX 4096
+
+ARRAY_DEF(ProtoPirateArchiveOffsetArray, uint32_t, M_POD_OPLIST)
+ARRAY_DEF(ProtoPirateArchivePathArray, FuriString *, M_POD_OPLIST)
+
+struct ProtoPirateArchive
+{
+    Storage *storage;
+    File *file;
+    // File offset of each record's length prefix
+    ProtoPirateArchiveOffsetArray_t offsets;
+    // End of the last record, the index block starts here
+    uint32_t data_end;
+    // The file holds bytes past data_end: a stale index or a torn record
+    bool has_tail;
+    // The bytes past data_end are a current index block and footer
+    bool indexed;
+};
+
+// Flipper is little endian, so integers are stored as they are in memory
+static bool protopirate_archive_read_u32(File *file, uint32_t *value)
+{
+    return storage_file_read(file, value, sizeof(uint32_t)) == sizeof(uint32_t);
+}
+
+static bool protopirate_archive_write_u32(File *file, uint32_t value)
+{
+    return storage_file_write(file, &value, sizeof(uint32_t)) == sizeof(uint32_t);
+}
+
+static ProtoPirateArchive *protopirate_archive_alloc()
+{
+    ProtoPirateArchive *instance = malloc(sizeof(ProtoPirateArchive));
+    instance->storage = furi_record_open(RECORD_STORAGE);
+    instance->file = storage_file_alloc(instance->storage);
+    ProtoPirateArchiveOffsetArray_init(instance->offsets);
+    instance->data_end = PROTOPIRATE_ARCHIVE_HEADER_SIZE;
+    instance->has_tail = false;
+    instance->indexed = false;
+    return instance;
+}
+
+static void protopirate_archive_free(ProtoPirateArchive *instance)
+{
+    storage_file_close(instance->file);
+    storage_file_free(instance->file);
+    ProtoPirateArchiveOffsetArray_clear(instance->offsets);
+    furi_record_close(RECORD_STORAGE);
+    free(instance);
+}
+
+ProtoPirateArchive *protopirate_archive_create(FuriString *out_path)
+{
+    if (!protopirate_storage_init())
+    {
+        FURI_LOG_E(TAG, "Failed to create app folder");
+        return NULL;
+    }
+
+    ProtoPirateArchive *instance = protopirate_archive_alloc();
+    FuriString *name = furi_string_alloc();
+    FuriString *path = furi_string_alloc();
+    bool result = false;
+
+    do
+    {
+        // Once per session, so probing for a free name is fine here
+        storage_get_next_filename(
+            instance->storage,
+            PROTOPIRATE_APP_FOLDER,
+            "session",
+            PROTOPIRATE_ARCHIVE_EXTENSION,
+            name,
+            64);
+        furi_string_printf(
+            path,
+            "%s/%s%s",
+            PROTOPIRATE_APP_FOLDER,
+            furi_string_get_cstr(name),
+            PROTOPIRATE_ARCHIVE_EXTENSION);
+
+        if (!storage_file_open(
+                instance->file, furi_string_get_cstr(path), FSAM_READ_WRITE, FSOM_CREATE_NEW))
+        {
+            FURI_LOG_E(TAG, "Failed to create %s", furi_string_get_cstr(path));
+            break;
+        }
+        if (storage_file_write(instance->file, PROTOPIRATE_ARCHIVE_MAGIC, 4) != 4 ||
+            !protopirate_archive_write_u32(instance->file, PROTOPIRATE_ARCHIVE_VERSION))
+        {
+            FURI_LOG_E(TAG, "Failed to write header");
+            break;
+        }
+        result = true;
+    } while (false);
+
+    if (result)
+    {
+        FURI_LOG_I(TAG, "Session archive %s", furi_string_get_cstr(path));
+        if (out_path)
+        {
+            furi_string_set(out_path, path);
+        }
+    }
+    else
+    {
+        protopirate_archive_free(instance);
+        instance = NULL;
+    }
+
+    furi_string_free(name);
+    furi_string_free(path);
+    return instance;
+}
+
+static bool protopirate_archive_load_index(ProtoPirateArchive *instance, uint32_t size)
+{
+    File *file = instance->file;
+    uint32_t count, index_offset;
+    char magic[4];
+
+    if (size < PROTOPIRATE_ARCHIVE_HEADER_SIZE + PROTOPIRATE_ARCHIVE_FOOTER_SIZE)
+        return false;
+    if (!storage_file_seek(file, size - PROTOPIRATE_ARCHIVE_FOOTER_SIZE, true) ||
+        !protopirate_archive_read_u32(file, &count) ||
+        !protopirate_archive_read_u32(file, &index_offset) ||
+        storage_file_read(file, magic, sizeof(magic)) != sizeof(magic) ||
+        memcmp(magic, PROTOPIRATE_ARCHIVE_INDEX_MAGIC, sizeof(magic)))
+        return false;
+    // A corrupt count must not wrap the size check or size the offset array
+    if (count > (size - PROTOPIRATE_ARCHIVE_HEADER_SIZE - PROTOPIRATE_ARCHIVE_FOOTER_SIZE) /
+                    sizeof(uint32_t) ||
+        index_offset < PROTOPIRATE_ARCHIVE_HEADER_SIZE ||
+        (uint64_t)index_offset + (uint64_t)count * sizeof(uint32_t) +
+                PROTOPIRATE_ARCHIVE_FOOTER_SIZE !=
+            size)
+        return false;
+
+    ProtoPirateArchiveOffsetArray_resize(instance->offsets, count);
+    if (count && (!storage_file_seek(file, index_offset, true) ||
+                  storage_file_read(
+                      file,
+                      ProtoPirateArchiveOffsetArray_get(instance->offsets, 0),
+                      count * sizeof(uint32_t)) != count * sizeof(uint32_t)))
+    {
+        ProtoPirateArchiveOffsetArray_reset(instance->offsets);
+        return false;
+    }
+
+    instance->data_end = index_offset;
+    instance->has_tail = true;
+    instance->indexed = true;
+    return true;
+}
+
+// Walks the length prefixes of an archive that was not closed cleanly
+static void protopirate_archive_recover(ProtoPirateArchive *instance, uint32_t size)
+{
+    File *file = instance->file;
+    uint32_t offset = PROTOPIRATE_ARCHIVE_HEADER_SIZE;
+    uint32_t length;
+    char last;
+
+    ProtoPirateArchiveOffsetArray_reset(instance->offsets);
+    while (storage_file_seek(file, offset, true) && protopirate_archive_read_u32(file, &length))
+    {
+        // Every record is whole key/value lines, so it ends with a newline
+        if (length == 0 || length > PROTOPIRATE_ARCHIVE_RECORD_MAX ||
+            (uint64_t)offset + sizeof(uint32_t) + length > size ||
+            !storage_file_seek(file, offset + sizeof(uint32_t) + length - 1, true) ||
+            storage_file_read(file, &last, 1) != 1 || last != '\n')
+            break;
+
+        ProtoPirateArchiveOffsetArray_push_back(instance->offsets, offset);
+        offset += sizeof(uint32_t) + length;
+    }
+
+    instance->data_end = offset;
+    instance->has_tail = offset < size;
+    instance->indexed = false;
+    FURI_LOG_W(
+        TAG,
+        "Recovered %zu records",
+        ProtoPirateArchiveOffsetArray_size(instance->offsets));
+}
+
+static ProtoPirateArchive *protopirate_archive_open(const char *path)
+{
+    ProtoPirateArchive *instance = protopirate_archive_alloc();
+    char magic[4];
+    uint32_t version;
+
+    if (!storage_file_open(instance->file, path, FSAM_READ_WRITE, FSOM_OPEN_EXISTING) ||
+        storage_file_read(instance->file, magic, sizeof(magic)) != sizeof(magic) ||
+        memcmp(magic, PROTOPIRATE_ARCHIVE_MAGIC, sizeof(magic)) ||
+        !protopirate_archive_read_u32(instance->file, &version) ||
+        version != PROTOPIRATE_ARCHIVE_VERSION)
+    {
+        FURI_LOG_E(TAG, "Not an archive: %s", path);
+        protopirate_archive_free(instance);
+        return NULL;
+    }
+
+    uint32_t size = storage_file_size(instance->file);
+    if (!protopirate_archive_load_index(instance, size))
+    {
+        protopirate_archive_recover(instance, size);
+    }
+
+    return instance;
+}
+
+bool protopirate_archive_sync(ProtoPirateArchive *instance)
+{
+    furi_assert(instance);
+
+    if (instance->indexed)
+    {
+        return true;
+    }
+
+    File *file = instance->file;
+    uint32_t count = ProtoPirateArchiveOffsetArray_size(instance->offsets);
+    bool result =
+        storage_file_seek(file, instance->data_end, true) &&
+        (!count || storage_file_write(
+                       file,
+                       ProtoPirateArchiveOffsetArray_get(instance->offsets, 0),
+                       count * sizeof(uint32_t)) == count * sizeof(uint32_t)) &&
+        protopirate_archive_write_u32(file, count) &&
+        protopirate_archive_write_u32(file, instance->data_end) &&
+        storage_file_write(file, PROTOPIRATE_ARCHIVE_INDEX_MAGIC, 4) == 4 &&
+        storage_file_truncate(file) && storage_file_sync(file);
+
+    instance->has_tail = true;
+    instance->indexed = result;
+    if (!result)
+    {
+        FURI_LOG_E(TAG, "Failed to write index");
+    }
+    return result;
+}
+
+void protopirate_archive_close(ProtoPirateArchive *instance)
+{
+    furi_assert(instance);
+    protopirate_archive_sync(instance);
+    protopirate_archive_free(instance);
+}
+
+static uint32_t protopirate_archive_get_count(ProtoPirateArchive *instance)
+{
+    furi_assert(instance);
+    return ProtoPirateArchiveOffsetArray_size(instance->offsets);
+}
+
+bool protopirate_archive_append(ProtoPirateArchive *instance, FlipperFormat *flipper_format)
+{
+    furi_assert(instance);
+    furi_assert(flipper_format);
+
+    if (!protopirate_storage_seek_keys(flipper_format))
+    {
+        return false;
+    }
+
+    Stream *stream = flipper_format_get_raw_stream(flipper_format);
+    uint32_t length = stream_size(stream) - stream_tell(stream);
+    if (length == 0 || length > PROTOPIRATE_ARCHIVE_RECORD_MAX)
+    {
+        FURI_LOG_E(TAG, "Bad record length %lu", length);
+        return false;
+    }
+
+    File *file = instance->file;
+    if (!storage_file_seek(file, instance->data_end, true))
+    {
+        return false;
+    }
+    // Drop the old index block once, records then grow the file at the end
+    if (instance->has_tail)
+    {
+        if (!storage_file_truncate(file))
+        {
+            return false;
+        }
+        instance->has_tail = false;
+    }
+    instance->indexed = false;
+
+    uint8_t buffer[PROTOPIRATE_ARCHIVE_CHUNK_SIZE];
+    bool result = protopirate_archive_write_u32(file, length);
+    for (uint32_t left = length; result && left > 0;)
+    {
+        size_t chunk = MIN(left, sizeof(buffer));
+        result = stream_read(stream, buffer, chunk) == chunk &&
+                 storage_file_write(file, buffer, chunk) == chunk;
+        left -= chunk;
+    }
+
+    if (!result)
+    {
+        // The torn record is cut off by the next append or sync
+        instance->has_tail = true;
+        FURI_LOG_E(TAG, "Failed to append record");
+        return false;
+    }
+
+    ProtoPirateArchiveOffsetArray_push_back(instance->offsets, instance->data_end);
+    instance->data_end += sizeof(uint32_t) + length;
+    return true;
+}
+
+// Loads record index into a string FlipperFormat
+static bool protopirate_archive_read(
+    ProtoPirateArchive *instance,
+    uint32_t index,
+    FlipperFormat *flipper_format)
+{
+    furi_assert(instance);
+    furi_assert(flipper_format);
+
+    if (index >= ProtoPirateArchiveOffsetArray_size(instance->offsets))
+    {
+        return false;
+    }
+
+    File *file = instance->file;
+    uint32_t length;
+    if (!storage_file_seek(
+            file, *ProtoPirateArchiveOffsetArray_get(instance->offsets, index), true) ||
+        !protopirate_archive_read_u32(file, &length) || length > PROTOPIRATE_ARCHIVE_RECORD_MAX)
+    {
+        return false;
+    }
+
+    Stream *stream = flipper_format_get_raw_stream(flipper_format);
+    stream_clean(stream);
+
+    uint8_t buffer[PROTOPIRATE_ARCHIVE_CHUNK_SIZE];
+    bool result = true;
+    for (uint32_t left = length; result && left > 0;)
+    {
+        size_t chunk = MIN(left, sizeof(buffer));
+        result = storage_file_read(file, buffer, chunk) == chunk &&
+                 stream_write(stream, buffer, chunk) == chunk;
+        left -= chunk;
+    }
+
+    flipper_format_rewind(flipper_format);
+    return result;
+}
+
+// Saves record index as an individual SubGhz capture
+static bool protopirate_archive_export(ProtoPirateArchive *instance, uint32_t index)
+{
+    furi_assert(instance);
+
+    FlipperFormat *flipper_format = flipper_format_string_alloc();
+    FuriString *protocol = furi_string_alloc();
+    bool result = false;
+
+    if (protopirate_archive_read(instance, index, flipper_format))
+    {
+        if (!flipper_format_read_string(flipper_format, "Protocol", protocol))
+        {
+            furi_string_set_str(protocol, "Unknown");
+        }
+        result =
+            protopirate_storage_save_capture(flipper_format, furi_string_get_cstr(protocol), NULL);
+    }
+
+    furi_string_free(protocol);
+    flipper_format_free(flipper_format);
+    return result;
+}
+
+// Appends the capture at file_path as a record
+static bool protopirate_archive_import(ProtoPirateArchive *instance, const char *file_path)
+{
+    furi_assert(instance);
+
+    FlipperFormat *flipper_format = protopirate_storage_load_file(file_path);
+    if (!flipper_format)
+    {
+        return false;
+    }
+
+    bool result = protopirate_archive_append(instance, flipper_format);
+    flipper_format_free(flipper_format);
+    return result;
+}
+
+bool protopirate_archive_unpack_all(uint32_t *out_count)
+{
+    Storage *storage = furi_record_open(RECORD_STORAGE);
+    File *dir = storage_file_alloc(storage);
+    ProtoPirateArchivePathArray_t paths;
+    ProtoPirateArchivePathArray_init(paths);
+    FileInfo file_info;
+    char name[256];
+
+    // Names first, unpacking adds captures to the folder being listed
+    if (storage_dir_open(dir, PROTOPIRATE_APP_FOLDER))
+    {
+        const size_t extension_length = strlen(PROTOPIRATE_ARCHIVE_EXTENSION);
+        while (storage_dir_read(dir, &file_info, name, sizeof(name)))
+        {
+            size_t length = strlen(name);
+            if (!file_info_is_dir(&file_info) && length > extension_length &&
+                !strcmp(name + length - extension_length, PROTOPIRATE_ARCHIVE_EXTENSION))
+            {
+                ProtoPirateArchivePathArray_push_back(
+                    paths, furi_string_alloc_printf("%s/%s", PROTOPIRATE_APP_FOLDER, name));
+            }
+        }
+    }
+    storage_dir_close(dir);
+    storage_file_free(dir);
+
+    uint32_t count = 0;
+    bool result = true;
+    for (size_t i = 0; i < ProtoPirateArchivePathArray_size(paths); i++)
+    {
+        FuriString *path = *ProtoPirateArchivePathArray_get(paths, i);
+        // Fails for the archive this session is still writing to
+        ProtoPirateArchive *instance = protopirate_archive_open(furi_string_get_cstr(path));
+        if (instance)
+        {
+            uint32_t records = protopirate_archive_get_count(instance);
+            uint32_t exported = 0;
+            while (exported < records && protopirate_archive_export(instance, exported))
+            {
+                exported++;
+            }
+            count += exported;
+
+            if (exported == records)
+            {
+                protopirate_archive_close(instance);
+                storage_simply_remove(storage, furi_string_get_cstr(path));
+            }
+            else
+            {
+                // Kept with only the records left, the next unpack must not
+                // export the others twice. Close writes the shorter index.
+                ProtoPirateArchiveOffsetArray_remove_v(instance->offsets, 0, exported);
+                instance->indexed = false;
+                protopirate_archive_close(instance);
+                result = false;
+            }
+        }
+        furi_string_free(path);
+    }
+
+    ProtoPirateArchivePathArray_clear(paths);
+    furi_record_close(RECORD_STORAGE);
+
+    FURI_LOG_I(TAG, "Unpacked %lu records", count);
+    if (out_count)
+    {
+        *out_count = count;
+    }
+    return result;
+}
+
+bool protopirate_archive_pack_all(ProtoPirateArchive *instance, uint32_t *out_count)
+{
+    furi_assert(instance);
+
+    ProtoPirateArchivePathArray_t paths;
+    ProtoPirateArchivePathArray_init(paths);
+
+    // Paths first, every packed capture leaves the listing
+    uint32_t files = protopirate_storage_get_file_count();
+    for (uint32_t i = 0; i < files; i++)
+    {
+        FuriString *path = furi_string_alloc();
+        if (protopirate_storage_get_file_by_index(i, path, NULL))
+        {
+            ProtoPirateArchivePathArray_push_back(paths, path);
+        }
+        else
+        {
+            furi_string_free(path);
+        }
+    }
+
+    // Imported paths are moved to the front, then removed once the index
+    // holding their records is on the card
+    size_t imported = 0;
+    for (size_t i = 0; i < ProtoPirateArchivePathArray_size(paths); i++)
+    {
+        FuriString **path = ProtoPirateArchivePathArray_get(paths, i);
+        if (protopirate_archive_import(instance, furi_string_get_cstr(*path)))
+        {
+            FuriString *swap = *ProtoPirateArchivePathArray_get(paths, imported);
+            *ProtoPirateArchivePathArray_get(paths, imported++) = *path;
+            *path = swap;
+        }
+    }
+
+    bool synced = protopirate_archive_sync(instance);
+    uint32_t count = 0;
+    for (size_t i = 0; i < ProtoPirateArchivePathArray_size(paths); i++)
+    {
+        FuriString *path = *ProtoPirateArchivePathArray_get(paths, i);
+        if (synced && i < imported)
+        {
+            protopirate_storage_delete_file(furi_string_get_cstr(path));
+            count++;
+        }
+        furi_string_free(path);
+    }
+
+    bool result = synced && imported == files;
+    ProtoPirateArchivePathArray_clear(paths);
+
+    FURI_LOG_I(TAG, "Packed %lu captures", count);
+    if (out_count)
+    {
+        *out_count = count;
+    }
+    return result;
+}
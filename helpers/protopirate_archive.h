@@ -0,0 +1,38 @@
+// helpers/protopirate_archive.h
+#pragma once
+
+#include <furi.h>
+#include <flipper_format/flipper_format.h>
+
+#define PROTOPIRATE_ARCHIVE_EXTENSION ".ppa"
+
+// Append-only log of captures, one file per session instead of one .sub per
+// frame. Layout, all integers little endian:
+//
+//   "PPAR" u32 version
+//   { u32 length, length bytes of FlipperFormat key/value text } * count
+//   u32 offset[count]                       <- index block, written on sync
+//   u32 count, u32 index offset, "PPIX"     <- footer
+//
+// Appending overwrites the index block, which is rewritten by sync/close. An
+// archive left without a footer (e.g. power loss) is recovered by walking the
+// length prefixes.
+typedef struct ProtoPirateArchive ProtoPirateArchive;
+
+// Creates a new session archive in PROTOPIRATE_APP_FOLDER
+ProtoPirateArchive *protopirate_archive_create(FuriString *out_path);
+// Writes the index block and closes the file
+void protopirate_archive_close(ProtoPirateArchive *instance);
+bool protopirate_archive_sync(ProtoPirateArchive *instance);
+
+// Appends the keys of a capture, a SubGhz file header is skipped
+bool protopirate_archive_append(ProtoPirateArchive *instance, FlipperFormat *flipper_format);
+
+// Turns every record of every archive in PROTOPIRATE_APP_FOLDER into a
+// separate capture, so it can be browsed and emulated, and removes the
+// archives unpacked in full. A partly unpacked archive keeps only the records
+// left. An archive still open is skipped. Returns false if any record failed.
+bool protopirate_archive_unpack_all(uint32_t *out_count);
+// Imports every capture in the current listing into instance and removes
+// each one whose record was written. Returns false if any capture failed.
+bool protopirate_archive_pack_all(ProtoPirateArchive *instance, uint32_t *out_count);
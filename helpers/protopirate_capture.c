@@ -0,0 +1,318 @@
+// helpers/protopirate_capture.c
+#include "protopirate_capture.h"
+#include <storage/storage.h>
+#include <toolbox/stream/stream.h>
+#include <toolbox/stream/buffered_file_stream.h>
+
+#define TAG "ProtoPirateCapture"
+
+// Decoded captures are a few hundred bytes. Anything larger, e.g. a RAW
+// recording, is parsed straight from the file and not kept in memory.
+#define PROTOPIRATE_CAPTURE_SIZE_MAX 4096
+
+struct ProtoPirateCapture
+{
+    ProtoPirateCaptureInfo info;
+    FuriString *path;
+    FuriString *text;
+    uint32_t timestamp;
+    bool valid;
+    // Too large to cache, text is empty and the file is read again on use
+    bool streamed;
+};
+
+typedef struct
+{
+    const char *key;
+    ProtoPirateCaptureField field;
+    size_t offset;
+} ProtoPirateCaptureKey;
+
+static const ProtoPirateCaptureKey protopirate_capture_keys[] = {
+    {"Frequency", ProtoPirateCaptureFieldFrequency, offsetof(ProtoPirateCaptureInfo, frequency)},
+    {"Serial", ProtoPirateCaptureFieldSerial, offsetof(ProtoPirateCaptureInfo, serial)},
+    {"Btn", ProtoPirateCaptureFieldBtn, offsetof(ProtoPirateCaptureInfo, btn)},
+    {"Cnt", ProtoPirateCaptureFieldCnt, offsetof(ProtoPirateCaptureInfo, cnt)},
+    {"CRC", ProtoPirateCaptureFieldCrc, offsetof(ProtoPirateCaptureInfo, crc)},
+    {"Type", ProtoPirateCaptureFieldType, offsetof(ProtoPirateCaptureInfo, type)},
+    {"Bit", ProtoPirateCaptureFieldBit, offsetof(ProtoPirateCaptureInfo, bits)},
+};
+
+static uint64_t protopirate_capture_parse_key(const char *value, size_t length)
+{
+    uint64_t key = 0;
+    size_t digits = 0;
+    for (size_t i = 0; i < length && digits < 16; i++)
+    {
+        char c = value[i];
+        uint8_t nibble;
+        if (c >= '0' && c <= '9')
+            nibble = c - '0';
+        else if (c >= 'A' && c <= 'F')
+            nibble = c - 'A' + 10;
+        else if (c >= 'a' && c <= 'f')
+            nibble = c - 'a' + 10;
+        else
+            continue;
+        key = (key << 4) | nibble;
+        digits++;
+    }
+    return key;
+}
+
+ProtoPirateCapture *protopirate_capture_alloc(void)
+{
+    ProtoPirateCapture *instance = malloc(sizeof(ProtoPirateCapture));
+    instance->info.protocol = furi_string_alloc();
+    instance->info.fields = 0;
+    instance->path = furi_string_alloc();
+    instance->text = furi_string_alloc();
+    instance->timestamp = 0;
+    instance->valid = false;
+    instance->streamed = false;
+    return instance;
+}
+
+void protopirate_capture_free(ProtoPirateCapture *instance)
+{
+    furi_assert(instance);
+    furi_string_free(instance->info.protocol);
+    furi_string_free(instance->path);
+    furi_string_free(instance->text);
+    free(instance);
+}
+
+void protopirate_capture_reset(ProtoPirateCapture *instance)
+{
+    furi_assert(instance);
+    instance->valid = false;
+    instance->streamed = false;
+    furi_string_reset(instance->path);
+    furi_string_reset(instance->text);
+}
+
+// Leaves text empty and sets streamed for files over PROTOPIRATE_CAPTURE_SIZE_MAX
+static bool protopirate_capture_read_text(
+    Storage *storage,
+    const char *file_path,
+    FuriString *text,
+    bool *streamed)
+{
+    File *file = storage_file_alloc(storage);
+    bool result = false;
+
+    do
+    {
+        if (!storage_file_open(file, file_path, FSAM_READ, FSOM_OPEN_EXISTING))
+        {
+            break;
+        }
+
+        uint64_t size = storage_file_size(file);
+        *streamed = size > PROTOPIRATE_CAPTURE_SIZE_MAX;
+        if (*streamed)
+        {
+            furi_string_reset(text);
+            result = true;
+            break;
+        }
+        if (size == 0)
+        {
+            FURI_LOG_E(TAG, "Empty file");
+            break;
+        }
+
+        char *buffer = malloc(size + 1);
+        if (storage_file_read(file, buffer, size) == size)
+        {
+            buffer[size] = '\0';
+            furi_string_set_str(text, buffer);
+            result = true;
+        }
+        free(buffer);
+    } while (false);
+
+    storage_file_close(file);
+    storage_file_free(file);
+    return result;
+}
+
+void protopirate_capture_info_reset(ProtoPirateCaptureInfo *info)
+{
+    furi_string_reset(info->protocol);
+    info->fields = 0;
+}
+
+void protopirate_capture_parse_line(ProtoPirateCaptureInfo *info, const char *line, size_t length)
+{
+    while (length && (line[length - 1] == '\n' || line[length - 1] == '\r'))
+    {
+        length--;
+    }
+
+    const char *separator = memchr(line, ':', length);
+    if (!separator || separator + 1 >= line + length || separator[1] != ' ')
+    {
+        return;
+    }
+
+    size_t key_length = separator - line;
+    const char *value = separator + 2;
+    size_t value_length = line + length - value;
+
+    if (key_length == strlen("Protocol") && !strncmp(line, "Protocol", key_length))
+    {
+        if (!(info->fields & ProtoPirateCaptureFieldProtocol))
+        {
+            furi_string_set_strn(info->protocol, value, value_length);
+            info->fields |= ProtoPirateCaptureFieldProtocol;
+        }
+        return;
+    }
+
+    if (key_length == strlen("Key") && !strncmp(line, "Key", key_length))
+    {
+        if (!(info->fields & ProtoPirateCaptureFieldKey))
+        {
+            info->key = protopirate_capture_parse_key(value, value_length);
+            info->fields |= ProtoPirateCaptureFieldKey;
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < COUNT_OF(protopirate_capture_keys); i++)
+    {
+        const ProtoPirateCaptureKey *key = &protopirate_capture_keys[i];
+        if (key_length == strlen(key->key) && !strncmp(line, key->key, key_length))
+        {
+            if (!(info->fields & key->field))
+            {
+                *(uint32_t *)((uint8_t *)info + key->offset) = strtoul(value, NULL, 10);
+                info->fields |= key->field;
+            }
+            return;
+        }
+    }
+}
+
+static void protopirate_capture_parse(ProtoPirateCaptureInfo *info, const char *text)
+{
+    protopirate_capture_info_reset(info);
+
+    for (const char *line = text; *line;)
+    {
+        const char *end = strchr(line, '\n');
+        size_t length = end ? (size_t)(end - line) : strlen(line);
+        protopirate_capture_parse_line(info, line, length);
+
+        line += length;
+        if (*line == '\n')
+        {
+            line++;
+        }
+    }
+}
+
+// Same result as protopirate_capture_parse, one line in memory at a time
+static bool protopirate_capture_parse_file(
+    Storage *storage,
+    const char *file_path,
+    ProtoPirateCaptureInfo *info)
+{
+    Stream *stream = buffered_file_stream_alloc(storage);
+    FuriString *line = furi_string_alloc();
+    bool result = buffered_file_stream_open(stream, file_path, FSAM_READ, FSOM_OPEN_EXISTING);
+
+    protopirate_capture_info_reset(info);
+    while (result && stream_read_line(stream, line))
+    {
+        protopirate_capture_parse_line(info, furi_string_get_cstr(line), furi_string_size(line));
+    }
+
+    furi_string_free(line);
+    buffered_file_stream_close(stream);
+    stream_free(stream);
+    return result;
+}
+
+const ProtoPirateCaptureInfo *protopirate_capture_load(
+    ProtoPirateCapture *instance,
+    const char *file_path)
+{
+    furi_assert(instance);
+    furi_assert(file_path);
+
+    Storage *storage = furi_record_open(RECORD_STORAGE);
+    uint32_t timestamp = 0;
+    bool stamped = storage_common_timestamp(storage, file_path, &timestamp) == FSE_OK;
+
+    if (instance->valid && stamped && timestamp == instance->timestamp &&
+        furi_string_equal_str(instance->path, file_path))
+    {
+        furi_record_close(RECORD_STORAGE);
+        return &instance->info;
+    }
+
+    instance->valid =
+        protopirate_capture_read_text(storage, file_path, instance->text, &instance->streamed);
+    if (instance->valid)
+    {
+        if (instance->streamed)
+        {
+            instance->valid = protopirate_capture_parse_file(storage, file_path, &instance->info);
+        }
+        else
+        {
+            protopirate_capture_parse(&instance->info, furi_string_get_cstr(instance->text));
+        }
+    }
+    furi_record_close(RECORD_STORAGE);
+
+    if (!instance->valid)
+    {
+        FURI_LOG_E(TAG, "Failed to read %s", file_path);
+        protopirate_capture_reset(instance);
+        return NULL;
+    }
+
+    furi_string_set_str(instance->path, file_path);
+    // Without a timestamp the next load reads the file again
+    instance->valid = stamped;
+    instance->timestamp = timestamp;
+    return &instance->info;
+}
+
+bool protopirate_capture_is_streamed(ProtoPirateCapture *instance)
+{
+    furi_assert(instance);
+    return instance->streamed;
+}
+
+FlipperFormat *protopirate_capture_get_flipper_format(ProtoPirateCapture *instance)
+{
+    furi_assert(instance);
+
+    if (instance->streamed)
+    {
+        Storage *storage = furi_record_open(RECORD_STORAGE);
+        FlipperFormat *flipper_format = flipper_format_file_alloc(storage);
+        furi_record_close(RECORD_STORAGE);
+        if (!flipper_format_file_open_existing(
+                flipper_format, furi_string_get_cstr(instance->path)))
+        {
+            flipper_format_free(flipper_format);
+            return NULL;
+        }
+        return flipper_format;
+    }
+
+    if (furi_string_empty(instance->text))
+    {
+        return NULL;
+    }
+
+    FlipperFormat *flipper_format = flipper_format_string_alloc();
+    stream_write_string(flipper_format_get_raw_stream(flipper_format), instance->text);
+    flipper_format_rewind(flipper_format);
+    return flipper_format;
+}
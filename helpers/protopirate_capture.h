@@ -0,0 +1,61 @@
+// helpers/protopirate_capture.h
+#pragma once
+
+#include <furi.h>
+#include <flipper_format/flipper_format.h>
+
+typedef enum
+{
+    ProtoPirateCaptureFieldProtocol = (1 << 0),
+    ProtoPirateCaptureFieldFrequency = (1 << 1),
+    ProtoPirateCaptureFieldSerial = (1 << 2),
+    ProtoPirateCaptureFieldBtn = (1 << 3),
+    ProtoPirateCaptureFieldCnt = (1 << 4),
+    ProtoPirateCaptureFieldCrc = (1 << 5),
+    ProtoPirateCaptureFieldType = (1 << 6),
+    ProtoPirateCaptureFieldKey = (1 << 7),
+    ProtoPirateCaptureFieldBit = (1 << 8),
+} ProtoPirateCaptureField;
+
+// A saved capture parsed in one pass over the file. The file text is kept
+// as well, so the emulate scene needs no second read of the same file.
+typedef struct
+{
+    FuriString *protocol;
+    // Up to the first 64 bits of "Key", with or without spaces between bytes
+    uint64_t key;
+    uint32_t bits;
+    uint32_t frequency;
+    uint32_t serial;
+    uint32_t btn;
+    uint32_t cnt;
+    uint32_t crc;
+    uint32_t type;
+    // ProtoPirateCaptureField bits of the keys found in the file
+    uint32_t fields;
+} ProtoPirateCaptureInfo;
+
+void protopirate_capture_info_reset(ProtoPirateCaptureInfo *info);
+// Same rules as flipper_format reads after a rewind: "Key: value" lines,
+// the first occurrence of a key wins
+void protopirate_capture_parse_line(ProtoPirateCaptureInfo *info, const char *line, size_t length);
+
+// Single-entry cache of the last capture opened, keyed by path and mtime.
+// Text is kept for captures up to a few KB, larger ones are re-read on use.
+typedef struct ProtoPirateCapture ProtoPirateCapture;
+
+ProtoPirateCapture *protopirate_capture_alloc(void);
+void protopirate_capture_free(ProtoPirateCapture *instance);
+
+// Returns NULL if the file can't be read. Valid until the next load or reset.
+const ProtoPirateCaptureInfo *protopirate_capture_load(
+    ProtoPirateCapture *instance,
+    const char *file_path);
+// Forgets the cached file, e.g. after it was deleted
+void protopirate_capture_reset(ProtoPirateCapture *instance);
+
+// FlipperFormat of the loaded capture, owned by caller. A string copy of the
+// cached text, or the file itself for captures too large to cache.
+FlipperFormat *protopirate_capture_get_flipper_format(ProtoPirateCapture *instance);
+// The loaded capture was too large to cache, get_flipper_format opens the file
+bool protopirate_capture_is_streamed(ProtoPirateCapture *instance);
@@ -0,0 +1,307 @@
+// helpers/protopirate_export.c
+#include "protopirate_export.h"
+#include "protopirate_storage.h"
+#include "../protocols/protocol_items.h"
+#include <storage/storage.h>
+#include <stdarg.h>
+
+#define TAG "ProtoPirateExport"
+
+#define PROTOPIRATE_EXPORT_BUFFER_SIZE 512
+
+// Longest formatted value, a 64 bit key in hex
+#define PROTOPIRATE_EXPORT_VALUE_SIZE 24
+
+typedef struct
+{
+    Storage *storage;
+    File *file;
+    ProtoPirateExportFormat format;
+    uint8_t column;
+    bool result;
+    size_t length;
+    char buffer[PROTOPIRATE_EXPORT_BUFFER_SIZE];
+} ProtoPirateExportWriter;
+
+static const char *const protopirate_export_extensions[ProtoPirateExportFormatNum] = {
+    ".csv",
+    ".jsonl",
+};
+
+static void protopirate_export_flush(ProtoPirateExportWriter *writer)
+{
+    if (writer->length && writer->result)
+    {
+        writer->result = storage_file_write(writer->file, writer->buffer, writer->length) ==
+                         writer->length;
+    }
+    writer->length = 0;
+}
+
+static void protopirate_export_put(ProtoPirateExportWriter *writer, const char *format, ...)
+{
+    for (uint8_t attempt = 0; attempt < 2; attempt++)
+    {
+        size_t space = sizeof(writer->buffer) - writer->length;
+        va_list args;
+        va_start(args, format);
+        int length = vsnprintf(writer->buffer + writer->length, space, format, args);
+        va_end(args);
+
+        if (length >= 0 && (size_t)length < space)
+        {
+            writer->length += length;
+            return;
+        }
+        // Didn't fit, retry once with an empty buffer
+        protopirate_export_flush(writer);
+    }
+    writer->result = false;
+}
+
+// value NULL is an empty CSV cell or JSON null. Names come from the protocol
+// registry and the SubGhz setting and need no escaping.
+static void protopirate_export_field(
+    ProtoPirateExportWriter *writer,
+    const char *name,
+    const char *value,
+    bool quoted)
+{
+    if (writer->format == ProtoPirateExportFormatJsonl)
+    {
+        protopirate_export_put(writer, writer->column ? ",\"%s\":" : "{\"%s\":", name);
+        protopirate_export_put(writer, !value ? "null" : (quoted ? "\"%s\"" : "%s"), value);
+    }
+    else
+    {
+        if (writer->column)
+        {
+            protopirate_export_put(writer, ",");
+        }
+        if (value)
+        {
+            protopirate_export_put(writer, "%s", value);
+        }
+    }
+    writer->column++;
+}
+
+static void protopirate_export_field_uint(
+    ProtoPirateExportWriter *writer,
+    const char *name,
+    uint32_t value,
+    bool present)
+{
+    char text[PROTOPIRATE_EXPORT_VALUE_SIZE];
+    snprintf(text, sizeof(text), "%lu", value);
+    protopirate_export_field(writer, name, present ? text : NULL, false);
+}
+
+static void protopirate_export_end_row(ProtoPirateExportWriter *writer)
+{
+    protopirate_export_put(writer, writer->format == ProtoPirateExportFormatJsonl ? "}\n" : "\n");
+    writer->column = 0;
+}
+
+static void protopirate_export_row(
+    ProtoPirateExportWriter *writer,
+    const char *protocol,
+    uint64_t key,
+    uint16_t bits,
+    bool has_key,
+    uint32_t serial,
+    uint8_t btn,
+    uint32_t cnt,
+    uint32_t frequency,
+    const char *preset,
+    uint32_t timestamp,
+    const int8_t *rssi,
+    uint32_t fields)
+{
+    char text[PROTOPIRATE_EXPORT_VALUE_SIZE];
+
+    protopirate_export_field(writer, "protocol", protocol, true);
+
+    // As many hex digits as the key has bits
+    uint8_t digits = bits ? MIN((bits + 3) / 4, 16) : 16;
+    snprintf(text, sizeof(text), "%0*llX", digits, key);
+    protopirate_export_field(writer, "key", has_key ? text : NULL, true);
+
+    protopirate_export_field_uint(writer, "bits", bits, fields & ProtoPirateCaptureFieldBit);
+    snprintf(text, sizeof(text), "%08lX", serial);
+    protopirate_export_field(
+        writer, "serial", (fields & ProtoPirateCaptureFieldSerial) ? text : NULL, true);
+    protopirate_export_field_uint(writer, "btn", btn, fields & ProtoPirateCaptureFieldBtn);
+    protopirate_export_field_uint(writer, "cnt", cnt, fields & ProtoPirateCaptureFieldCnt);
+    protopirate_export_field_uint(
+        writer, "frequency", frequency, fields & ProtoPirateCaptureFieldFrequency);
+    protopirate_export_field(writer, "preset", preset, true);
+    protopirate_export_field_uint(writer, "timestamp", timestamp, timestamp != 0);
+    if (rssi)
+    {
+        snprintf(text, sizeof(text), "%d", *rssi);
+    }
+    protopirate_export_field(writer, "rssi", rssi ? text : NULL, false);
+
+    protopirate_export_end_row(writer);
+}
+
+static ProtoPirateExportWriter *
+protopirate_export_open(ProtoPirateExportFormat format, FuriString *out_path)
+{
+    furi_assert(format < ProtoPirateExportFormatNum);
+
+    if (!protopirate_storage_init())
+    {
+        FURI_LOG_E(TAG, "Failed to create app folder");
+        return NULL;
+    }
+
+    ProtoPirateExportWriter *writer = malloc(sizeof(ProtoPirateExportWriter));
+    writer->storage = furi_record_open(RECORD_STORAGE);
+    writer->file = storage_file_alloc(writer->storage);
+    writer->format = format;
+    writer->column = 0;
+    writer->length = 0;
+    writer->result = true;
+
+    FuriString *name = furi_string_alloc();
+    FuriString *path = furi_string_alloc();
+    storage_get_next_filename(
+        writer->storage,
+        PROTOPIRATE_APP_FOLDER,
+        "export",
+        protopirate_export_extensions[format],
+        name,
+        64);
+    furi_string_printf(
+        path,
+        "%s/%s%s",
+        PROTOPIRATE_APP_FOLDER,
+        furi_string_get_cstr(name),
+        protopirate_export_extensions[format]);
+    furi_string_free(name);
+
+    if (!storage_file_open(
+            writer->file, furi_string_get_cstr(path), FSAM_WRITE, FSOM_CREATE_NEW))
+    {
+        FURI_LOG_E(TAG, "Failed to create %s", furi_string_get_cstr(path));
+        storage_file_free(writer->file);
+        furi_record_close(RECORD_STORAGE);
+        free(writer);
+        furi_string_free(path);
+        return NULL;
+    }
+
+    FURI_LOG_I(TAG, "Exporting to %s", furi_string_get_cstr(path));
+    if (out_path)
+    {
+        furi_string_set(out_path, path);
+    }
+    furi_string_free(path);
+
+    if (format == ProtoPirateExportFormatCsv)
+    {
+        protopirate_export_put(
+            writer, "protocol,key,bits,serial,btn,cnt,frequency,preset,timestamp,rssi\n");
+    }
+    return writer;
+}
+
+static bool protopirate_export_close(ProtoPirateExportWriter *writer)
+{
+    protopirate_export_flush(writer);
+    bool result = writer->result;
+
+    storage_file_close(writer->file);
+    storage_file_free(writer->file);
+    furi_record_close(RECORD_STORAGE);
+    free(writer);
+
+    if (!result)
+    {
+        FURI_LOG_E(TAG, "Export failed");
+    }
+    return result;
+}
+
+bool protopirate_export_history(
+    ProtoPirateHistory *history,
+    ProtoPirateExportFormat format,
+    FuriString *out_path)
+{
+    furi_assert(history);
+
+    ProtoPirateExportWriter *writer = protopirate_export_open(format, out_path);
+    if (!writer)
+    {
+        return false;
+    }
+
+    // Everything is known for a decoded frame
+    const uint32_t fields = ProtoPirateCaptureFieldBit | ProtoPirateCaptureFieldSerial |
+                            ProtoPirateCaptureFieldBtn | ProtoPirateCaptureFieldCnt |
+                            ProtoPirateCaptureFieldFrequency;
+    ProtoPirateHistoryEntry entry;
+    uint16_t count = protopirate_history_get_item(history);
+    for (uint16_t idx = 0; idx < count && writer->result; idx++)
+    {
+        protopirate_history_get_entry(history, idx, &entry);
+        protopirate_export_row(
+            writer,
+            entry.name,
+            entry.key,
+            entry.bits,
+            true,
+            entry.serial,
+            entry.btn,
+            entry.cnt,
+            entry.frequency,
+            entry.preset,
+            entry.timestamp,
+            &entry.rssi,
+            fields);
+    }
+
+    FURI_LOG_I(TAG, "Exported %u history entries", count);
+    return protopirate_export_close(writer);
+}
+
+bool protopirate_export_saved(ProtoPirateExportFormat format, FuriString *out_path)
+{
+    ProtoPirateExportWriter *writer = protopirate_export_open(format, out_path);
+    if (!writer)
+    {
+        return false;
+    }
+
+    ProtoPirateStorageInfo info;
+    uint32_t count = protopirate_storage_get_file_count();
+    for (uint32_t i = 0; i < count && writer->result; i++)
+    {
+        if (!protopirate_storage_get_info_by_index(i, &info))
+        {
+            break;
+        }
+
+        protopirate_export_row(
+            writer,
+            (info.fields & ProtoPirateCaptureFieldProtocol) ?
+                protopirate_protocol_registry.items[info.protocol]->name :
+                NULL,
+            info.key,
+            info.bits,
+            info.fields & ProtoPirateCaptureFieldKey,
+            info.serial,
+            info.btn,
+            info.cnt,
+            info.frequency,
+            NULL,
+            info.timestamp,
+            NULL,
+            info.fields);
+    }
+
+    FURI_LOG_I(TAG, "Exported %lu saved captures", count);
+    return protopirate_export_close(writer);
+}
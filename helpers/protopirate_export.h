@@ -0,0 +1,24 @@
+// helpers/protopirate_export.h
+#pragma once
+
+#include <furi.h>
+#include "../protopirate_history.h"
+
+typedef enum
+{
+    ProtoPirateExportFormatCsv,
+    ProtoPirateExportFormatJsonl,
+    ProtoPirateExportFormatNum,
+} ProtoPirateExportFormat;
+
+// One row per capture with protocol, key, bits, serial, btn, cnt,
+// frequency, preset, timestamp and RSSI, to a new export file in
+// PROTOPIRATE_APP_FOLDER. Rows go through a fixed-size buffer, so memory use
+// doesn't depend on the number of rows.
+bool protopirate_export_history(
+    ProtoPirateHistory *history,
+    ProtoPirateExportFormat format,
+    FuriString *out_path);
+// Saved captures in the current listing order and filter, from the index
+// alone. Preset and RSSI are not indexed and left empty.
+bool protopirate_export_saved(ProtoPirateExportFormat format, FuriString *out_path);
@@ -0,0 +1,93 @@
+// helpers/protopirate_frame_ring.c
+#include "protopirate_frame_ring.h"
+
+// Power of two, so free-running indices wrap with a mask
+#define PROTOPIRATE_FRAME_RING_SIZE 8
+#define PROTOPIRATE_FRAME_RING_MASK (PROTOPIRATE_FRAME_RING_SIZE - 1)
+
+struct ProtoPirateFrameRing
+{
+    ProtoPirateFrame frames[PROTOPIRATE_FRAME_RING_SIZE];
+    // head is written only by the producer, tail only by the consumer
+    uint32_t head;
+    uint32_t tail;
+    uint32_t dropped;
+};
+
+ProtoPirateFrameRing *protopirate_frame_ring_alloc(void)
+{
+    ProtoPirateFrameRing *instance = malloc(sizeof(ProtoPirateFrameRing));
+    instance->head = 0;
+    instance->tail = 0;
+    instance->dropped = 0;
+    return instance;
+}
+
+void protopirate_frame_ring_free(ProtoPirateFrameRing *instance)
+{
+    furi_assert(instance);
+    free(instance);
+}
+
+void protopirate_frame_ring_reset(ProtoPirateFrameRing *instance)
+{
+    furi_assert(instance);
+    __atomic_store_n(
+        &instance->tail, __atomic_load_n(&instance->head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+    instance->dropped = 0;
+}
+
+bool protopirate_frame_ring_push(
+    ProtoPirateFrameRing *instance,
+    const SubGhzProtocolDecoderBase *decoder,
+    size_t decoder_size,
+    uint32_t frequency,
+    uint8_t preset,
+    float rssi,
+    uint32_t timestamp)
+{
+    furi_assert(instance);
+    furi_assert(decoder);
+    furi_check(decoder_size <= PROTOPIRATE_FRAME_DECODER_SIZE);
+
+    const uint32_t head = instance->head;
+    if (head - __atomic_load_n(&instance->tail, __ATOMIC_ACQUIRE) >= PROTOPIRATE_FRAME_RING_SIZE)
+    {
+        instance->dropped++;
+        return false;
+    }
+
+    ProtoPirateFrame *frame = &instance->frames[head & PROTOPIRATE_FRAME_RING_MASK];
+    frame->frequency = frequency;
+    frame->preset = preset;
+    frame->rssi = rssi;
+    frame->timestamp = timestamp;
+    memcpy(frame->decoder.raw, decoder, decoder_size);
+
+    __atomic_store_n(&instance->head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+ProtoPirateFrame *protopirate_frame_ring_peek(ProtoPirateFrameRing *instance)
+{
+    furi_assert(instance);
+
+    const uint32_t tail = instance->tail;
+    if (tail == __atomic_load_n(&instance->head, __ATOMIC_ACQUIRE))
+    {
+        return NULL;
+    }
+    return &instance->frames[tail & PROTOPIRATE_FRAME_RING_MASK];
+}
+
+void protopirate_frame_ring_release(ProtoPirateFrameRing *instance)
+{
+    furi_assert(instance);
+    __atomic_store_n(&instance->tail, instance->tail + 1, __ATOMIC_RELEASE);
+}
+
+uint32_t protopirate_frame_ring_get_dropped(ProtoPirateFrameRing *instance)
+{
+    furi_assert(instance);
+    return __atomic_load_n(&instance->dropped, __ATOMIC_RELAXED);
+}
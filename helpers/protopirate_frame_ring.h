@@ -0,0 +1,50 @@
+// helpers/protopirate_frame_ring.h
+#pragma once
+
+#include <furi.h>
+#include <lib/subghz/protocols/base.h>
+
+// Largest decoder instance a frame can carry, checked per protocol at startup
+#define PROTOPIRATE_FRAME_DECODER_SIZE 192
+
+// Decoded frame handed from the SubGhz worker to the GUI thread. The decoder
+// instance is copied byte for byte, so get_string/serialize/get_hash_data can
+// run on the copy while the live decoder keeps receiving.
+typedef struct
+{
+    uint32_t frequency;
+    // SubGhzSetting preset index the frame was received with
+    uint8_t preset;
+    // Sampled in the worker callback, the GUI thread may drain the ring late
+    float rssi;
+    uint32_t timestamp;
+    union
+    {
+        SubGhzProtocolDecoderBase base;
+        uint64_t align;
+        uint8_t raw[PROTOPIRATE_FRAME_DECODER_SIZE];
+    } decoder;
+} ProtoPirateFrame;
+
+// Lock-free single-producer (worker) / single-consumer (GUI) frame ring
+typedef struct ProtoPirateFrameRing ProtoPirateFrameRing;
+
+ProtoPirateFrameRing *protopirate_frame_ring_alloc(void);
+void protopirate_frame_ring_free(ProtoPirateFrameRing *instance);
+// Drops pending frames, only while the producer is stopped
+void protopirate_frame_ring_reset(ProtoPirateFrameRing *instance);
+
+// Producer side. Returns false and counts a drop when the ring is full.
+bool protopirate_frame_ring_push(
+    ProtoPirateFrameRing *instance,
+    const SubGhzProtocolDecoderBase *decoder,
+    size_t decoder_size,
+    uint32_t frequency,
+    uint8_t preset,
+    float rssi,
+    uint32_t timestamp);
+
+// Consumer side. The peeked frame stays valid until released.
+ProtoPirateFrame *protopirate_frame_ring_peek(ProtoPirateFrameRing *instance);
+void protopirate_frame_ring_release(ProtoPirateFrameRing *instance);
+uint32_t protopirate_frame_ring_get_dropped(ProtoPirateFrameRing *instance);
@@ -0,0 +1,348 @@
+// helpers/protopirate_hopper.c
+#include "protopirate_hopper.h"
+#include <furi_hal.h>
+
+#define TAG "ProtoPirateHopper"
+
+// A decode is stronger evidence of traffic than an RSSI pause, which may be noise
+#define PROTOPIRATE_HOPPER_HIT_WEIGHT 64
+#define PROTOPIRATE_HOPPER_PAUSE_WEIGHT 16
+// Activity keeps 3/4 per round, a single decode still counts ~15 rounds later
+#define PROTOPIRATE_HOPPER_DECAY_SHIFT 2
+// Noise floor is the 20th percentile, moved in steps of up to 1 dB
+#define PROTOPIRATE_NOISE_FLOOR_PERCENTILE 0.2f
+#define PROTOPIRATE_NOISE_FLOOR_STEP 1.0f
+#define PROTOPIRATE_NOISE_FLOOR_SAMPLES_MIN 16
+// Signals need this much over the floor, within sane absolute limits
+#define PROTOPIRATE_NOISE_FLOOR_MARGIN 10.0f
+#define PROTOPIRATE_NOISE_FLOOR_THRESHOLD_MIN -105.0f
+#define PROTOPIRATE_NOISE_FLOOR_THRESHOLD_MAX -60.0f
+#define PROTOPIRATE_NOISE_FLOOR_THRESHOLD_DEFAULT -90.0f
+// Mean jitter average weight, 1/16 per tick
+#define PROTOPIRATE_HOPPER_JITTER_SHIFT 4
+
+struct ProtoPirateHopper
+{
+    ProtoPirateHopperChannel *channels;
+    size_t count;
+    size_t index;
+    // Ticks left on the current frequency
+    uint8_t remaining;
+
+    // DWT cycle count of the last tick
+    uint32_t marked;
+    bool marking;
+    ProtoPirateHopperJitter jitter;
+};
+
+void protopirate_noise_floor_reset(ProtoPirateNoiseFloor *noise)
+{
+    furi_assert(noise);
+    noise->level = 0.0f;
+    noise->samples = 0;
+}
+
+void protopirate_noise_floor_add(ProtoPirateNoiseFloor *noise, float rssi)
+{
+    furi_assert(noise);
+
+    if (noise->samples == 0)
+    {
+        noise->level = rssi;
+    }
+    // Stochastic quantile estimate: settles where the share of samples
+    // below level equals the percentile
+    else if (rssi < noise->level)
+    {
+        noise->level -= PROTOPIRATE_NOISE_FLOOR_STEP * (1.0f - PROTOPIRATE_NOISE_FLOOR_PERCENTILE);
+    }
+    else
+    {
+        noise->level += PROTOPIRATE_NOISE_FLOOR_STEP * PROTOPIRATE_NOISE_FLOOR_PERCENTILE;
+    }
+
+    if (noise->samples < UINT16_MAX)
+    {
+        noise->samples++;
+    }
+}
+
+bool protopirate_noise_floor_is_valid(const ProtoPirateNoiseFloor *noise)
+{
+    furi_assert(noise);
+    return noise->samples >= PROTOPIRATE_NOISE_FLOOR_SAMPLES_MIN;
+}
+
+float protopirate_noise_floor_get_threshold(const ProtoPirateNoiseFloor *noise)
+{
+    furi_assert(noise);
+
+    if (!protopirate_noise_floor_is_valid(noise))
+    {
+        return PROTOPIRATE_NOISE_FLOOR_THRESHOLD_DEFAULT;
+    }
+    return CLAMP(
+        noise->level + PROTOPIRATE_NOISE_FLOOR_MARGIN,
+        PROTOPIRATE_NOISE_FLOOR_THRESHOLD_MAX,
+        PROTOPIRATE_NOISE_FLOOR_THRESHOLD_MIN);
+}
+
+static void protopirate_hopper_channel_init(
+    ProtoPirateHopperChannel *channel,
+    uint32_t frequency,
+    uint8_t preset)
+{
+    channel->frequency = frequency;
+    channel->preset = preset;
+    channel->hits = 0;
+    channel->pauses = 0;
+    channel->activity = 0;
+    protopirate_noise_floor_reset(&channel->noise);
+    channel->dwell = 1;
+}
+
+ProtoPirateHopper *protopirate_hopper_alloc(SubGhzSetting *setting)
+{
+    furi_assert(setting);
+
+    ProtoPirateHopper *instance = malloc(sizeof(ProtoPirateHopper));
+    instance->channels = NULL;
+    instance->count = 0;
+    instance->marking = false;
+    memset(&instance->jitter, 0, sizeof(ProtoPirateHopperJitter));
+
+    const uint8_t preset = PROTOPIRATE_HOPPER_PRESET_CURRENT;
+    protopirate_hopper_set_presets(instance, setting, &preset, 1);
+    return instance;
+}
+
+void protopirate_hopper_set_presets(
+    ProtoPirateHopper *instance,
+    SubGhzSetting *setting,
+    const uint8_t *presets,
+    size_t preset_count)
+{
+    furi_assert(instance);
+    furi_assert(setting);
+    furi_assert(presets);
+
+    size_t frequency_count = subghz_setting_get_hopper_frequency_count(setting);
+    size_t count = frequency_count * preset_count;
+    ProtoPirateHopperChannel *channels =
+        malloc(sizeof(ProtoPirateHopperChannel) * MAX(count, 1u));
+
+    // All presets of a frequency back to back, a scan over the band
+    // still goes up in frequency
+    for (size_t i = 0; i < count; i++)
+    {
+        ProtoPirateHopperChannel *channel = &channels[i];
+        uint32_t frequency = subghz_setting_get_hopper_frequency(setting, i / preset_count);
+        uint8_t preset = presets[i % preset_count];
+
+        protopirate_hopper_channel_init(channel, frequency, preset);
+        for (size_t j = 0; j < instance->count; j++)
+        {
+            if (instance->channels[j].frequency == frequency &&
+                instance->channels[j].preset == preset)
+            {
+                *channel = instance->channels[j];
+                break;
+            }
+        }
+    }
+
+    free(instance->channels);
+    instance->channels = channels;
+    instance->count = count;
+    instance->index = 0;
+    instance->remaining = 1;
+}
+
+void protopirate_hopper_free(ProtoPirateHopper *instance)
+{
+    furi_assert(instance);
+    free(instance->channels);
+    free(instance);
+}
+
+// Weighted per tick of dwell, so activity follows the event rate and a
+// frequency doesn't earn more dwell just for having been listened to longer
+static void protopirate_hopper_add_activity(ProtoPirateHopperChannel *channel, uint16_t weight)
+{
+    channel->activity = MIN((uint32_t)channel->activity + weight / channel->dwell, UINT16_MAX);
+}
+
+// Shares the ticks of a round left after one per frequency by score
+static void protopirate_hopper_enter(ProtoPirateHopper *instance)
+{
+    ProtoPirateHopperChannel *channel = &instance->channels[instance->index];
+
+    uint32_t spare = PROTOPIRATE_HOPPER_ROUND_TICKS > instance->count ?
+                         PROTOPIRATE_HOPPER_ROUND_TICKS - instance->count :
+                         0;
+    uint32_t total = 0;
+    for (size_t i = 0; i < instance->count; i++)
+    {
+        total += instance->channels[i].activity;
+    }
+
+    channel->dwell = 1;
+    if (total)
+    {
+        channel->dwell += spare * channel->activity / total;
+    }
+    instance->remaining = channel->dwell;
+}
+
+static void protopirate_hopper_decay(ProtoPirateHopper *instance)
+{
+    for (size_t i = 0; i < instance->count; i++)
+    {
+        ProtoPirateHopperChannel *channel = &instance->channels[i];
+        // Rounded up, so a channel left with a few hits still decays to 0
+        channel->activity -=
+            (channel->activity + (1 << PROTOPIRATE_HOPPER_DECAY_SHIFT) - 1) >>
+            PROTOPIRATE_HOPPER_DECAY_SHIFT;
+    }
+}
+
+const ProtoPirateHopperChannel *protopirate_hopper_start(ProtoPirateHopper *instance)
+{
+    furi_assert(instance);
+
+    instance->index = 0;
+    instance->marking = false;
+    memset(&instance->jitter, 0, sizeof(ProtoPirateHopperJitter));
+    if (!instance->count)
+    {
+        return NULL;
+    }
+    protopirate_hopper_enter(instance);
+    return &instance->channels[0];
+}
+
+bool protopirate_hopper_tick(
+    ProtoPirateHopper *instance,
+    const ProtoPirateHopperChannel **channel)
+{
+    furi_assert(instance);
+
+    if (instance->remaining > 1)
+    {
+        instance->remaining--;
+        return false;
+    }
+    return protopirate_hopper_next(instance, channel);
+}
+
+bool protopirate_hopper_next(
+    ProtoPirateHopper *instance,
+    const ProtoPirateHopperChannel **channel)
+{
+    furi_assert(instance);
+    furi_assert(channel);
+
+    if (instance->count < 2)
+    {
+        return false;
+    }
+
+    instance->index++;
+    if (instance->index == instance->count)
+    {
+        instance->index = 0;
+        protopirate_hopper_decay(instance);
+    }
+    protopirate_hopper_enter(instance);
+
+    *channel = &instance->channels[instance->index];
+    return true;
+}
+
+void protopirate_hopper_add_rssi(ProtoPirateHopper *instance, float rssi)
+{
+    furi_assert(instance);
+    if (instance->count)
+    {
+        protopirate_noise_floor_add(&instance->channels[instance->index].noise, rssi);
+    }
+}
+
+const ProtoPirateNoiseFloor *protopirate_hopper_get_noise(ProtoPirateHopper *instance)
+{
+    furi_assert(instance);
+    return instance->count ? &instance->channels[instance->index].noise : NULL;
+}
+
+void protopirate_hopper_add_pause(ProtoPirateHopper *instance)
+{
+    furi_assert(instance);
+    if (!instance->count)
+    {
+        return;
+    }
+
+    ProtoPirateHopperChannel *channel = &instance->channels[instance->index];
+    if (channel->pauses < UINT16_MAX)
+    {
+        channel->pauses++;
+    }
+    protopirate_hopper_add_activity(channel, PROTOPIRATE_HOPPER_PAUSE_WEIGHT);
+}
+
+void protopirate_hopper_add_hit(ProtoPirateHopper *instance, uint32_t frequency, uint8_t preset)
+{
+    furi_assert(instance);
+    for (size_t i = 0; i < instance->count; i++)
+    {
+        ProtoPirateHopperChannel *channel = &instance->channels[i];
+        if (channel->frequency == frequency &&
+            (channel->preset == preset || channel->preset == PROTOPIRATE_HOPPER_PRESET_CURRENT))
+        {
+            if (channel->hits < UINT16_MAX)
+            {
+                channel->hits++;
+            }
+            protopirate_hopper_add_activity(channel, PROTOPIRATE_HOPPER_HIT_WEIGHT);
+            FURI_LOG_D(TAG, "Hit on %lu, %u hits", frequency, channel->hits);
+            return;
+        }
+    }
+}
+
+void protopirate_hopper_mark(ProtoPirateHopper *instance, uint32_t period_us)
+{
+    furi_assert(instance);
+
+    uint32_t now = DWT->CYCCNT;
+    if (!instance->marking)
+    {
+        instance->marking = true;
+        instance->marked = now;
+        return;
+    }
+
+    // Wraps after ~67 s at 64 MHz, far longer than any dwell
+    uint32_t elapsed = (now - instance->marked) / furi_hal_cortex_instructions_per_microsecond();
+    instance->marked = now;
+
+    ProtoPirateHopperJitter *jitter = &instance->jitter;
+    jitter->last = elapsed > period_us ? elapsed - period_us : period_us - elapsed;
+    jitter->max = MAX(jitter->max, jitter->last);
+    if (jitter->mean == 0)
+    {
+        jitter->mean = jitter->last;
+    }
+    else
+    {
+        jitter->mean = jitter->mean - (jitter->mean >> PROTOPIRATE_HOPPER_JITTER_SHIFT) +
+                       (jitter->last >> PROTOPIRATE_HOPPER_JITTER_SHIFT);
+    }
+}
+
+void protopirate_hopper_get_jitter(ProtoPirateHopper *instance, ProtoPirateHopperJitter *jitter)
+{
+    furi_assert(instance);
+    furi_assert(jitter);
+    *jitter = instance->jitter;
+}
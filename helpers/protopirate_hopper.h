@@ -0,0 +1,99 @@
+// helpers/protopirate_hopper.h
+#pragma once
+
+#include <furi.h>
+#include <lib/subghz/subghz_setting.h>
+
+// Longest round over the hop list, in hopper ticks. Every channel gets at
+// least one tick per round, the rest of the round is shared out by
+// activity, so busy channels get more dwell time while dead ones are still
+// revisited at least this often.
+#define PROTOPIRATE_HOPPER_ROUND_TICKS 30
+// How long to stay on a frequency after a decode or RSSI spike
+#define PROTOPIRATE_HOPPER_HOLD_MS 1000
+
+// Low percentile of RSSI, tracked one sample at a time in O(1) memory.
+// Short bursts above it barely move it, so it follows the noise floor
+// rather than the traffic.
+typedef struct
+{
+    float level;
+    uint16_t samples;
+} ProtoPirateNoiseFloor;
+
+void protopirate_noise_floor_reset(ProtoPirateNoiseFloor *noise);
+void protopirate_noise_floor_add(ProtoPirateNoiseFloor *noise, float rssi);
+// Enough samples for level to mean something
+bool protopirate_noise_floor_is_valid(const ProtoPirateNoiseFloor *noise);
+// RSSI a signal has to exceed: a margin over the floor once valid, the
+// old fixed -90 dBm before that
+float protopirate_noise_floor_get_threshold(const ProtoPirateNoiseFloor *noise);
+
+// Channel preset that keeps whatever modulation the receiver was set to
+#define PROTOPIRATE_HOPPER_PRESET_CURRENT UINT8_MAX
+
+// One hop list entry, a frequency with the preset to receive it with
+typedef struct
+{
+    uint32_t frequency;
+    // Index into the SubGhzSetting preset list
+    uint8_t preset;
+    // Decodes and RSSI pauses since the app started
+    uint16_t hits;
+    uint16_t pauses;
+    // Both of the above weighted and decayed once per round, sets the dwell
+    uint16_t activity;
+    ProtoPirateNoiseFloor noise;
+    // Ticks given to this channel on its last visit
+    uint8_t dwell;
+} ProtoPirateHopperChannel;
+
+// How far hop ticks land from the dwell period, microseconds
+typedef struct
+{
+    uint32_t last;
+    uint32_t mean;
+    uint32_t max;
+} ProtoPirateHopperJitter;
+
+// Dwell scheduler over a hop list of (frequency, preset) channels
+typedef struct ProtoPirateHopper ProtoPirateHopper;
+
+// Starts with the hopper frequencies of setting on the current preset.
+// The list is copied, setting can be freed first.
+ProtoPirateHopper *protopirate_hopper_alloc(SubGhzSetting *setting);
+void protopirate_hopper_free(ProtoPirateHopper *instance);
+
+// Hop list becomes every hopper frequency of setting with each of presets.
+// Channels also in the old list keep their statistics.
+void protopirate_hopper_set_presets(
+    ProtoPirateHopper *instance,
+    SubGhzSetting *setting,
+    const uint8_t *presets,
+    size_t preset_count);
+
+// Returns the first channel of a new round or NULL if the list is empty,
+// statistics are kept
+const ProtoPirateHopperChannel *protopirate_hopper_start(ProtoPirateHopper *instance);
+// Counts one tick on the current channel. Returns true with the next
+// channel once its dwell is used up.
+bool protopirate_hopper_tick(
+    ProtoPirateHopper *instance,
+    const ProtoPirateHopperChannel **channel);
+// Moves on right away, e.g. after a pause. False with fewer than two channels.
+bool protopirate_hopper_next(
+    ProtoPirateHopper *instance,
+    const ProtoPirateHopperChannel **channel);
+
+// Statistics feeds
+void protopirate_hopper_add_rssi(ProtoPirateHopper *instance, float rssi);
+// Noise floor of the current channel, NULL if the list is empty
+const ProtoPirateNoiseFloor *protopirate_hopper_get_noise(ProtoPirateHopper *instance);
+void protopirate_hopper_add_pause(ProtoPirateHopper *instance);
+// frequency and preset are the ones the frame was decoded on, which can lag a hop
+void protopirate_hopper_add_hit(ProtoPirateHopper *instance, uint32_t frequency, uint8_t preset);
+
+// Called at the start of every hop tick, the first call after start only
+// sets the reference point
+void protopirate_hopper_mark(ProtoPirateHopper *instance, uint32_t period_us);
+void protopirate_hopper_get_jitter(ProtoPirateHopper *instance, ProtoPirateHopperJitter *jitter);
@@ -1,304 +1,1068 @@
 // helpers/protopirate_storage.c
 #include "protopirate_storage.h"
+#include "protopirate_capture.h"
+#include "../protocols/protocol_items.h"
 #include <toolbox/stream/file_stream.h>
 #include <toolbox/dir_walk.h>
+#include <m-array.h>
 
 #define TAG "ProtoPirateStorage"
 
-bool protopirate_storage_init()
+#define PROTOPIRATE_INDEX_PATH PROTOPIRATE_APP_FOLDER "/.index"
+#define PROTOPIRATE_INDEX_MAGIC "PPSI"
+#define PROTOPIRATE_INDEX_VERSION 5
+// Longest name a record holds, with the terminator. An index with a longer
+// name is not kept on SD and the folder is scanned again next session.
+#define PROTOPIRATE_INDEX_NAME_SIZE 64
+#define PROTOPIRATE_INDEX_PROTOCOL_NAME_SIZE 16
+// Records read or written per SD call when the whole index is loaded or written
+#define PROTOPIRATE_INDEX_BATCH 8
+// Tombstones are compacted away on load once they make up a quarter of the file
+#define PROTOPIRATE_INDEX_COMPACT_SHIFT 2
+#define PROTOPIRATE_INDEX_RECORD_NONE UINT32_MAX
+// New names tried per save before giving up, see protopirate_storage_save_capture
+#define PROTOPIRATE_STORAGE_NAME_ATTEMPTS 8
+
+// On-disk index, written whole only on a rebuild or compaction. A save
+// appends one record and a delete sets removed on one, so both cost a
+// constant number of writes however many captures there are.
+//
+//   header, protocol_count names of PROTOPIRATE_INDEX_PROTOCOL_NAME_SIZE bytes,
+//   records of record_size bytes
+typedef struct
 {
-    Storage *storage = furi_record_open(RECORD_STORAGE);
-    bool result = storage_simply_mkdir(storage, PROTOPIRATE_APP_FOLDER);
-    furi_record_close(RECORD_STORAGE);
-    return result;
+    char magic[4];
+    uint16_t version;
+    uint16_t record_size;
+    // Folder timestamp the file was last written against
+    uint32_t timestamp;
+    // Records refer to protocols by position in the table after the header
+    uint8_t protocol_count;
+    uint8_t reserved[3];
+} ProtoPirateStorageIndexHeader;
+
+typedef struct
+{
+    uint64_t key;
+    uint32_t timestamp;
+    uint32_t frequency;
+    uint32_t serial;
+    uint32_t cnt;
+    uint16_t bits;
+    uint16_t fields;
+    uint8_t btn;
+    uint8_t protocol;
+    // Tombstone, the capture was deleted
+    uint8_t removed;
+    char name[PROTOPIRATE_INDEX_NAME_SIZE];
+} ProtoPirateStorageIndexRecord;
+
+typedef struct
+{
+    FuriString *name;
+    uint64_t key;
+    uint32_t timestamp;
+    uint32_t frequency;
+    uint32_t serial;
+    uint32_t cnt;
+    uint16_t bits;
+    // ProtoPirateCaptureField bits of the values above
+    uint16_t fields;
+    uint8_t btn;
+    // Index into protopirate_protocol_registry
+    uint8_t protocol;
+    // Position in the index file, PROTOPIRATE_INDEX_RECORD_NONE if not written
+    uint32_t record;
+} ProtoPirateStorageEntry;
+
+ARRAY_DEF(ProtoPirateStorageEntryArray, ProtoPirateStorageEntry, M_POD_OPLIST)
+ARRAY_DEF(ProtoPirateStorageViewArray, uint32_t, M_POD_OPLIST)
+
+// File names, mtimes and key fields of saved captures, built in one pass and
+// kept until the app exits. Our own save/delete calls keep it current.
+static ProtoPirateStorageEntryArray_t protopirate_storage_entries;
+static bool protopirate_storage_index_valid = false;
+// The index file holds every entry, records counts its tombstones too
+static bool protopirate_storage_index_persisted = false;
+static uint32_t protopirate_storage_index_records = 0;
+// Listing order, the entries are re-sorted lazily after a save or rebuild
+static ProtoPirateStorageSort protopirate_storage_sort = ProtoPirateStorageSortName;
+static bool protopirate_storage_sorted = false;
+// Positions of the entries matching the filter, rebuilt lazily like the sort
+static ProtoPirateStorageFilter protopirate_storage_filter;
+static ProtoPirateStorageViewArray_t protopirate_storage_view;
+static bool protopirate_storage_view_valid = false;
+// Guards the index and counters, saves run on the storage worker thread
+static FuriMutex *protopirate_storage_mutex = NULL;
+
+// Next free file number per protocol, seeded from the index on first save
+typedef struct
+{
+    FuriString *protocol;
+    uint32_t next;
+} ProtoPirateStorageCounter;
+
+ARRAY_DEF(ProtoPirateStorageCounterArray, ProtoPirateStorageCounter, M_POD_OPLIST)
+
+static ProtoPirateStorageCounterArray_t protopirate_storage_counters;
+
+static bool protopirate_storage_is_capture(const FileInfo *file_info, const char *name)
+{
+    return !file_info_is_dir(file_info) && strstr(name, PROTOPIRATE_APP_EXTENSION);
 }
 
-bool protopirate_storage_get_next_filename(
-    const char *protocol_name,
-    FuriString *out_filename)
+static void protopirate_storage_lock()
+{
+    furi_check(furi_mutex_acquire(protopirate_storage_mutex, FuriWaitForever) == FuriStatusOk);
+}
+
+static void protopirate_storage_unlock()
 {
+    furi_check(furi_mutex_release(protopirate_storage_mutex) == FuriStatusOk);
+}
 
-    Storage *storage = furi_record_open(RECORD_STORAGE);
-    FuriString *temp_path = furi_string_alloc();
-    uint32_t index = 0;
-    bool found = false;
-
-    // Find next available index
-    while (!found && index < 999)
-    {
-        furi_string_printf(
-            temp_path,
-            "%s/%s_%03lu%s",
-            PROTOPIRATE_APP_FOLDER,
-            protocol_name,
-            index,
-            PROTOPIRATE_APP_EXTENSION);
-
-        if (!storage_file_exists(storage, furi_string_get_cstr(temp_path)))
+static void protopirate_storage_index_clear()
+{
+    for (size_t i = 0; i < ProtoPirateStorageEntryArray_size(protopirate_storage_entries); i++)
+    {
+        furi_string_free(ProtoPirateStorageEntryArray_get(protopirate_storage_entries, i)->name);
+    }
+    ProtoPirateStorageEntryArray_reset(protopirate_storage_entries);
+
+    for (size_t i = 0; i < ProtoPirateStorageCounterArray_size(protopirate_storage_counters); i++)
+    {
+        furi_string_free(
+            ProtoPirateStorageCounterArray_get(protopirate_storage_counters, i)->protocol);
+    }
+    ProtoPirateStorageCounterArray_reset(protopirate_storage_counters);
+
+    protopirate_storage_index_valid = false;
+    protopirate_storage_index_persisted = false;
+    protopirate_storage_index_records = 0;
+    protopirate_storage_sorted = false;
+    protopirate_storage_view_valid = false;
+}
+
+static uint8_t protopirate_storage_find_protocol(const char *protocol_name)
+{
+    for (size_t i = 0; i < protopirate_protocol_registry.size; i++)
+    {
+        if (!strcmp(protopirate_protocol_registry.items[i]->name, protocol_name))
         {
-            furi_string_set(out_filename, temp_path);
-            found = true;
+            return i;
         }
-        else
+    }
+    return PROTOPIRATE_STORAGE_PROTOCOL_UNKNOWN;
+}
+
+// Fills the key fields of entry in one pass over the lines of a capture
+static void protopirate_storage_read_meta(
+    FlipperFormat *flipper_format,
+    ProtoPirateStorageEntry *entry)
+{
+    ProtoPirateCaptureInfo info = {.protocol = furi_string_alloc()};
+    protopirate_capture_info_reset(&info);
+
+    if (protopirate_storage_seek_keys(flipper_format))
+    {
+        Stream *stream = flipper_format_get_raw_stream(flipper_format);
+        FuriString *line = furi_string_alloc();
+        while (stream_read_line(stream, line))
         {
-            index++;
+            protopirate_capture_parse_line(
+                &info, furi_string_get_cstr(line), furi_string_size(line));
         }
+        furi_string_free(line);
     }
 
-    furi_string_free(temp_path);
-    furi_record_close(RECORD_STORAGE);
+    entry->key = info.key;
+    entry->bits = info.bits;
+    entry->frequency = info.frequency;
+    entry->serial = info.serial;
+    entry->cnt = info.cnt;
+    entry->btn = info.btn;
+    entry->protocol = PROTOPIRATE_STORAGE_PROTOCOL_UNKNOWN;
+    entry->fields = info.fields &
+                    (ProtoPirateCaptureFieldKey | ProtoPirateCaptureFieldBit |
+                     ProtoPirateCaptureFieldFrequency | ProtoPirateCaptureFieldSerial |
+                     ProtoPirateCaptureFieldBtn | ProtoPirateCaptureFieldCnt);
+    if (info.fields & ProtoPirateCaptureFieldProtocol)
+    {
+        entry->protocol = protopirate_storage_find_protocol(furi_string_get_cstr(info.protocol));
+        if (entry->protocol != PROTOPIRATE_STORAGE_PROTOCOL_UNKNOWN)
+        {
+            entry->fields |= ProtoPirateCaptureFieldProtocol;
+        }
+    }
 
-    return found;
+    furi_string_free(info.protocol);
 }
 
-bool protopirate_storage_save_capture(
-    FlipperFormat *flipper_format,
-    const char *protocol_name,
-    FuriString *out_path)
+static ProtoPirateStorageEntry *
+protopirate_storage_index_push(const char *name, uint32_t timestamp)
 {
+    ProtoPirateStorageEntry *entry =
+        ProtoPirateStorageEntryArray_push_raw(protopirate_storage_entries);
+    entry->name = furi_string_alloc_set_str(name);
+    entry->timestamp = timestamp;
+    entry->protocol = PROTOPIRATE_STORAGE_PROTOCOL_UNKNOWN;
+    entry->fields = 0;
+    entry->record = PROTOPIRATE_INDEX_RECORD_NONE;
+    protopirate_storage_sorted = false;
+    protopirate_storage_view_valid = false;
+    return entry;
+}
 
-    if (!protopirate_storage_init())
+static void protopirate_storage_index_scan(Storage *storage)
+{
+    File *dir = storage_file_alloc(storage);
+    FlipperFormat *flipper_format = flipper_format_file_alloc(storage);
+    FileInfo file_info;
+    FuriString *path = furi_string_alloc();
+
+    if (storage_dir_open(dir, PROTOPIRATE_APP_FOLDER))
+    {
+        char name[256];
+        while (storage_dir_read(dir, &file_info, name, sizeof(name)))
+        {
+            if (protopirate_storage_is_capture(&file_info, name))
+            {
+                uint32_t timestamp = 0;
+                furi_string_printf(path, "%s/%s", PROTOPIRATE_APP_FOLDER, name);
+                storage_common_timestamp(storage, furi_string_get_cstr(path), &timestamp);
+                ProtoPirateStorageEntry *entry = protopirate_storage_index_push(name, timestamp);
+
+                // Only paid on a rebuild, afterwards the index answers queries
+                if (flipper_format_file_open_existing(
+                        flipper_format, furi_string_get_cstr(path)))
+                {
+                    protopirate_storage_read_meta(flipper_format, entry);
+                }
+                flipper_format_file_close(flipper_format);
+            }
+        }
+    }
+
+    storage_dir_close(dir);
+    storage_file_free(dir);
+    flipper_format_free(flipper_format);
+    furi_string_free(path);
+}
+
+static uint32_t protopirate_storage_index_data_offset(uint8_t protocol_count)
+{
+    return sizeof(ProtoPirateStorageIndexHeader) +
+           protocol_count * PROTOPIRATE_INDEX_PROTOCOL_NAME_SIZE;
+}
+
+// Removes the index file, the next session scans the folder instead
+static void protopirate_storage_index_discard(Storage *storage)
+{
+    storage_simply_remove(storage, PROTOPIRATE_INDEX_PATH);
+    protopirate_storage_index_persisted = false;
+}
+
+static bool protopirate_storage_index_fill(
+    ProtoPirateStorageIndexRecord *record,
+    const ProtoPirateStorageEntry *entry)
+{
+    size_t length = furi_string_size(entry->name);
+    if (length >= PROTOPIRATE_INDEX_NAME_SIZE)
     {
-        FURI_LOG_E(TAG, "Failed to create app folder");
         return false;
     }
 
-    FuriString *file_path = furi_string_alloc();
+    // Zeroes the padding too, records are written as they are in memory
+    memset(record, 0, sizeof(ProtoPirateStorageIndexRecord));
+    record->key = entry->key;
+    record->timestamp = entry->timestamp;
+    record->frequency = entry->frequency;
+    record->serial = entry->serial;
+    record->cnt = entry->cnt;
+    record->bits = entry->bits;
+    record->fields = entry->fields;
+    record->btn = entry->btn;
+    record->protocol = entry->protocol;
+    memcpy(record->name, furi_string_get_cstr(entry->name), length);
+    return true;
+}
 
-    if (!protopirate_storage_get_next_filename(protocol_name, file_path))
+static bool protopirate_storage_index_push_record(
+    const ProtoPirateStorageIndexRecord *record,
+    const uint8_t *protocol_map,
+    uint8_t protocol_count,
+    uint32_t position)
+{
+    if (!memchr(record->name, '\0', sizeof(record->name)))
     {
-        FURI_LOG_E(TAG, "Failed to get next filename");
-        furi_string_free(file_path);
         return false;
     }
 
-    Storage *storage = furi_record_open(RECORD_STORAGE);
+    ProtoPirateStorageEntry *entry =
+        protopirate_storage_index_push(record->name, record->timestamp);
+    entry->key = record->key;
+    entry->frequency = record->frequency;
+    entry->serial = record->serial;
+    entry->cnt = record->cnt;
+    entry->bits = record->bits;
+    entry->fields = record->fields;
+    entry->btn = record->btn;
+    if (record->protocol < protocol_count)
+    {
+        entry->protocol = protocol_map[record->protocol];
+    }
+    if (entry->protocol == PROTOPIRATE_STORAGE_PROTOCOL_UNKNOWN)
+    {
+        entry->fields &= ~ProtoPirateCaptureFieldProtocol;
+    }
+    entry->record = position;
+    return true;
+}
 
-    // Create a new flipper format file for saving
-    FlipperFormat *save_file = flipper_format_file_alloc(storage);
+// The persisted index is trusted only while the folder timestamp matches.
+// compact is set when the file should be written anew, to drop tombstones
+// or because the protocol registry changed since it was written.
+static bool protopirate_storage_index_load(Storage *storage, uint32_t timestamp, bool *compact)
+{
+    File *file = storage_file_alloc(storage);
+    ProtoPirateStorageIndexHeader header;
+    ProtoPirateStorageIndexRecord *records =
+        malloc(sizeof(ProtoPirateStorageIndexRecord) * PROTOPIRATE_INDEX_BATCH);
+    // Stored protocol ids to current ones, the registry may have changed
+    uint8_t protocol_map[PROTOPIRATE_STORAGE_PROTOCOL_UNKNOWN];
+    uint32_t count = 0;
+    uint32_t removed = 0;
     bool result = false;
 
+    *compact = false;
     do
     {
-        if (!flipper_format_file_open_new(save_file, furi_string_get_cstr(file_path)))
-        {
-            FURI_LOG_E(TAG, "Failed to create file");
+        if (!storage_file_open(file, PROTOPIRATE_INDEX_PATH, FSAM_READ, FSOM_OPEN_EXISTING))
             break;
-        }
-
-        // Write standard SubGhz file header
-        if (!flipper_format_write_header_cstr(save_file, "Flipper SubGhz", 1))
-        {
-            FURI_LOG_E(TAG, "Failed to write header");
+        if (storage_file_read(file, &header, sizeof(header)) != sizeof(header) ||
+            memcmp(header.magic, PROTOPIRATE_INDEX_MAGIC, sizeof(header.magic)) ||
+            header.version != PROTOPIRATE_INDEX_VERSION ||
+            header.record_size != sizeof(ProtoPirateStorageIndexRecord) ||
+            header.timestamp != timestamp ||
+            header.protocol_count == PROTOPIRATE_STORAGE_PROTOCOL_UNKNOWN)
             break;
-        }
-
-        // Rewind source format to beginning
-        flipper_format_rewind(flipper_format);
-
-        // Copy ALL data from the source flipper format
-        FuriString *string_value = furi_string_alloc();
-        uint32_t uint32_value;
-        uint32_t *uint32_array = NULL;
-        uint32_t uint32_array_size = 0;
 
-        // Protocol name
-        if (flipper_format_read_string(flipper_format, "Protocol", string_value))
+        char name[PROTOPIRATE_INDEX_PROTOCOL_NAME_SIZE];
+        uint32_t i = 0;
+        for (; i < header.protocol_count; i++)
         {
-            flipper_format_write_string(save_file, "Protocol", string_value);
+            if (storage_file_read(file, name, sizeof(name)) != sizeof(name))
+                break;
+            name[sizeof(name) - 1] = '\0';
+            protocol_map[i] = protopirate_storage_find_protocol(name);
+            // Appended records carry current ids, so the table must match
+            if (protocol_map[i] != i)
+            {
+                *compact = true;
+            }
         }
-
-        // Bit count
-        if (flipper_format_read_uint32(flipper_format, "Bit", &uint32_value, 1))
+        if (i != header.protocol_count)
+            break;
+        if (header.protocol_count != protopirate_protocol_registry.size)
         {
-            flipper_format_write_uint32(save_file, "Bit", &uint32_value, 1);
-            FURI_LOG_I(TAG, "Saving Bit count: %lu", uint32_value);
+            *compact = true;
         }
 
-        // Key data - could be hex string or uint32 array
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_string(flipper_format, "Key", string_value))
-        {
-            flipper_format_write_string(save_file, "Key", string_value);
-        }
-        else
+        uint64_t size = storage_file_size(file);
+        uint32_t data_offset = protopirate_storage_index_data_offset(header.protocol_count);
+        // A torn append leaves part of a record behind
+        if (size < data_offset || (size - data_offset) % sizeof(ProtoPirateStorageIndexRecord))
+            break;
+        size -= data_offset;
+        count = size / sizeof(ProtoPirateStorageIndexRecord);
+
+        bool valid = true;
+        for (i = 0; i < count && valid;)
         {
-            // Try reading as uint32 array for raw data
-            flipper_format_rewind(flipper_format);
-            if (flipper_format_get_value_count(flipper_format, "Key", &uint32_array_size))
+            uint32_t batch = MIN(count - i, (uint32_t)PROTOPIRATE_INDEX_BATCH);
+            size_t bytes = batch * sizeof(ProtoPirateStorageIndexRecord);
+            if (storage_file_read(file, records, bytes) != bytes)
+            {
+                valid = false;
+                break;
+            }
+            for (uint32_t j = 0; j < batch && valid; j++, i++)
             {
-                uint32_array = malloc(sizeof(uint32_t) * uint32_array_size);
-                if (flipper_format_read_uint32(flipper_format, "Key", uint32_array, uint32_array_size))
+                if (records[j].removed)
                 {
-                    flipper_format_write_uint32(save_file, "Key", uint32_array, uint32_array_size);
+                    removed++;
+                    continue;
                 }
-                free(uint32_array);
-                uint32_array = NULL;
+                valid = protopirate_storage_index_push_record(
+                    &records[j], protocol_map, header.protocol_count, i);
             }
         }
+        result = valid;
+    } while (false);
 
-        // Frequency
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "Frequency", &uint32_value, 1))
-        {
-            flipper_format_write_uint32(save_file, "Frequency", &uint32_value, 1);
-        }
+    storage_file_close(file);
+    storage_file_free(file);
+    free(records);
 
-        // Preset
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_string(flipper_format, "Preset", string_value))
+    if (result)
+    {
+        protopirate_storage_index_persisted = true;
+        protopirate_storage_index_records = count;
+        if ((removed << PROTOPIRATE_INDEX_COMPACT_SHIFT) > count)
         {
-            flipper_format_write_string(save_file, "Preset", string_value);
+            *compact = true;
         }
+    }
+    else
+    {
+        protopirate_storage_index_clear();
+    }
+    return result;
+}
 
-        // Custom preset data if exists
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_get_value_count(flipper_format, "Custom_preset_module", &uint32_array_size))
-        {
-            if (flipper_format_read_string(flipper_format, "Custom_preset_module", string_value))
-            {
-                flipper_format_write_string(save_file, "Custom_preset_module", string_value);
-            }
-        }
+static uint32_t protopirate_storage_name_hash(const char *name)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261UL;
+    for (; *name; name++)
+    {
+        hash = (hash ^ (uint8_t)*name) * 16777619UL;
+    }
+    return hash;
+}
+
+// FAT doesn't touch a folder's timestamp when files are added or removed, so
+// captures copied in over USB would go unnoticed. One listing pass without
+// opening any file compares the capture count and an order-independent sum
+// of name hashes with the loaded index.
+static bool protopirate_storage_index_is_current(Storage *storage)
+{
+    File *dir = storage_file_alloc(storage);
+    FileInfo file_info;
+    size_t count = 0;
+    uint32_t sum = 0;
+    bool result = false;
 
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_get_value_count(flipper_format, "Custom_preset_data", &uint32_array_size))
+    if (storage_dir_open(dir, PROTOPIRATE_APP_FOLDER))
+    {
+        char name[256];
+        while (storage_dir_read(dir, &file_info, name, sizeof(name)))
         {
-            uint8_t *custom_data = malloc(uint32_array_size);
-            if (flipper_format_read_hex(flipper_format, "Custom_preset_data", custom_data, uint32_array_size))
+            if (protopirate_storage_is_capture(&file_info, name))
             {
-                flipper_format_write_hex(save_file, "Custom_preset_data", custom_data, uint32_array_size);
+                count++;
+                sum += protopirate_storage_name_hash(name);
             }
-            free(custom_data);
         }
+        result = true;
+    }
+    storage_dir_close(dir);
+    storage_file_free(dir);
 
-        // Protocol-specific fields
+    size_t size = ProtoPirateStorageEntryArray_size(protopirate_storage_entries);
+    for (size_t i = 0; i < size; i++)
+    {
+        const ProtoPirateStorageEntry *entry =
+            ProtoPirateStorageEntryArray_get(protopirate_storage_entries, i);
+        sum -= protopirate_storage_name_hash(furi_string_get_cstr(entry->name));
+    }
+    return result && count == size && sum == 0;
+}
 
-        // TE (timing) if exists
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "TE", &uint32_value, 1))
-        {
-            flipper_format_write_uint32(save_file, "TE", &uint32_value, 1);
-        }
+// Writes every entry out anew, only after a rebuild or to compact
+static void protopirate_storage_index_write(Storage *storage)
+{
+    File *file = storage_file_alloc(storage);
+    ProtoPirateStorageIndexHeader header;
+    ProtoPirateStorageIndexRecord *records =
+        malloc(sizeof(ProtoPirateStorageIndexRecord) * PROTOPIRATE_INDEX_BATCH);
+    size_t count = ProtoPirateStorageEntryArray_size(protopirate_storage_entries);
+    bool result = false;
 
-        // Serial number
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "Serial", &uint32_value, 1))
-        {
-            flipper_format_write_uint32(save_file, "Serial", &uint32_value, 1);
-        }
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, PROTOPIRATE_INDEX_MAGIC, sizeof(header.magic));
+    header.version = PROTOPIRATE_INDEX_VERSION;
+    header.record_size = sizeof(ProtoPirateStorageIndexRecord);
+    header.protocol_count = protopirate_protocol_registry.size;
+    storage_common_timestamp(storage, PROTOPIRATE_APP_FOLDER, &header.timestamp);
 
-        // Button
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "Btn", &uint32_value, 1))
-        {
-            flipper_format_write_uint32(save_file, "Btn", &uint32_value, 1);
-        }
+    do
+    {
+        if (!storage_file_open(file, PROTOPIRATE_INDEX_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS))
+            break;
+        if (storage_file_write(file, &header, sizeof(header)) != sizeof(header))
+            break;
 
-        // Counter
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "Cnt", &uint32_value, 1))
+        char name[PROTOPIRATE_INDEX_PROTOCOL_NAME_SIZE];
+        size_t i = 0;
+        for (; i < header.protocol_count; i++)
         {
-            flipper_format_write_uint32(save_file, "Cnt", &uint32_value, 1);
+            memset(name, 0, sizeof(name));
+            strncpy(name, protopirate_protocol_registry.items[i]->name, sizeof(name) - 1);
+            if (storage_file_write(file, name, sizeof(name)) != sizeof(name))
+                break;
         }
+        if (i != header.protocol_count)
+            break;
 
-        // CRC if exists
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "CRC", &uint32_value, 1))
+        bool valid = true;
+        for (i = 0; i < count && valid;)
         {
-            flipper_format_write_uint32(save_file, "CRC", &uint32_value, 1);
+            size_t batch = 0;
+            for (; batch < PROTOPIRATE_INDEX_BATCH && i < count && valid; batch++, i++)
+            {
+                ProtoPirateStorageEntry *entry =
+                    ProtoPirateStorageEntryArray_get(protopirate_storage_entries, i);
+                entry->record = i;
+                valid = protopirate_storage_index_fill(&records[batch], entry);
+            }
+            size_t bytes = batch * sizeof(ProtoPirateStorageIndexRecord);
+            valid = valid && storage_file_write(file, records, bytes) == bytes;
         }
+        result = valid;
+    } while (false);
 
-        // Type (for VW)
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "Type", &uint32_value, 1))
-        {
-            flipper_format_write_uint32(save_file, "Type", &uint32_value, 1);
-        }
+    storage_file_close(file);
+    storage_file_free(file);
+    free(records);
 
-        // Check (for VW)
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "Check", &uint32_value, 1))
+    if (result)
+    {
+        protopirate_storage_index_persisted = true;
+        protopirate_storage_index_records = count;
+    }
+    else
+    {
+        FURI_LOG_W(TAG, "Failed to write index");
+        protopirate_storage_index_discard(storage);
+    }
+}
+
+// Writes size bytes at offset into the index file and stamps it with the
+// folder timestamp, a constant number of writes
+static bool protopirate_storage_index_patch(
+    Storage *storage,
+    uint32_t offset,
+    const void *data,
+    size_t size)
+{
+    if (!protopirate_storage_index_persisted)
+    {
+        return false;
+    }
+
+    uint32_t timestamp = 0;
+    storage_common_timestamp(storage, PROTOPIRATE_APP_FOLDER, &timestamp);
+
+    File *file = storage_file_alloc(storage);
+    bool result =
+        storage_file_open(file, PROTOPIRATE_INDEX_PATH, FSAM_WRITE, FSOM_OPEN_EXISTING) &&
+        storage_file_seek(file, offset, true) && storage_file_write(file, data, size) == size &&
+        storage_file_seek(file, offsetof(ProtoPirateStorageIndexHeader, timestamp), true) &&
+        storage_file_write(file, &timestamp, sizeof(timestamp)) == sizeof(timestamp);
+    storage_file_close(file);
+    storage_file_free(file);
+
+    if (!result)
+    {
+        FURI_LOG_W(TAG, "Failed to update index");
+        protopirate_storage_index_discard(storage);
+    }
+    return result;
+}
+
+static uint32_t protopirate_storage_index_record_offset(uint32_t record)
+{
+    return protopirate_storage_index_data_offset(protopirate_protocol_registry.size) +
+           record * sizeof(ProtoPirateStorageIndexRecord);
+}
+
+static void protopirate_storage_index_append(Storage *storage, ProtoPirateStorageEntry *entry)
+{
+    ProtoPirateStorageIndexRecord record;
+    if (!protopirate_storage_index_persisted)
+    {
+        return;
+    }
+    if (!protopirate_storage_index_fill(&record, entry))
+    {
+        protopirate_storage_index_discard(storage);
+        return;
+    }
+
+    uint32_t position = protopirate_storage_index_records;
+    if (protopirate_storage_index_patch(
+            storage,
+            protopirate_storage_index_record_offset(position),
+            &record,
+            sizeof(record)))
+    {
+        entry->record = position;
+        protopirate_storage_index_records++;
+    }
+}
+
+static void protopirate_storage_index_tombstone(
+    Storage *storage,
+    const ProtoPirateStorageEntry *entry)
+{
+    if (entry->record == PROTOPIRATE_INDEX_RECORD_NONE)
+    {
+        return;
+    }
+
+    const uint8_t removed = 1;
+    protopirate_storage_index_patch(
+        storage,
+        protopirate_storage_index_record_offset(entry->record) +
+            offsetof(ProtoPirateStorageIndexRecord, removed),
+        &removed,
+        sizeof(removed));
+}
+
+// Rewrites the record of an entry whose key fields changed
+static void protopirate_storage_index_update(
+    Storage *storage,
+    const ProtoPirateStorageEntry *entry)
+{
+    ProtoPirateStorageIndexRecord record;
+    if (entry->record == PROTOPIRATE_INDEX_RECORD_NONE ||
+        !protopirate_storage_index_fill(&record, entry))
+    {
+        return;
+    }
+    protopirate_storage_index_patch(
+        storage, protopirate_storage_index_record_offset(entry->record), &record, sizeof(record));
+}
+
+// Builds the index on first use: from the persisted file when it still
+// matches the folder listing, otherwise from a full directory pass
+static void protopirate_storage_index_ensure(Storage *storage)
+{
+    if (protopirate_storage_index_valid)
+    {
+        return;
+    }
+
+    protopirate_storage_index_clear();
+
+    uint32_t timestamp = 0;
+    bool compact = false;
+    bool loaded = storage_common_timestamp(storage, PROTOPIRATE_APP_FOLDER, &timestamp) ==
+                      FSE_OK &&
+                  protopirate_storage_index_load(storage, timestamp, &compact);
+    if (loaded && !protopirate_storage_index_is_current(storage))
+    {
+        FURI_LOG_I(TAG, "Captures changed outside the app");
+        protopirate_storage_index_clear();
+        loaded = false;
+    }
+
+    if (loaded)
+    {
+        if (compact)
         {
-            flipper_format_write_uint32(save_file, "Check", &uint32_value, 1);
+            protopirate_storage_index_write(storage);
         }
+        FURI_LOG_I(TAG, compact ? "Index loaded and compacted" : "Index loaded");
+    }
+    else
+    {
+        protopirate_storage_index_scan(storage);
+        protopirate_storage_index_write(storage);
+        FURI_LOG_I(TAG, "Index rebuilt");
+    }
+
+    protopirate_storage_index_valid = true;
+}
 
-        // Raw data arrays if exist
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_get_value_count(flipper_format, "RAW_Data", &uint32_array_size))
+// Name of a capture path relative to the app folder
+static const char *protopirate_storage_get_name(const char *file_path)
+{
+    const char *name = strrchr(file_path, '/');
+    return name ? name + 1 : file_path;
+}
+
+// Length of the "<protocol>" part of "<protocol>_<n>.sub"
+static size_t protopirate_storage_protocol_length(const char *name)
+{
+    const char *separator = strrchr(name, '_');
+    return separator ? (size_t)(separator - name) : strlen(name);
+}
+
+static int protopirate_storage_compare_name(const void *a, const void *b)
+{
+    const ProtoPirateStorageEntry *entry_a = a;
+    const ProtoPirateStorageEntry *entry_b = b;
+    return furi_string_cmpi(entry_a->name, entry_b->name);
+}
+
+// Newest first, ties broken by name
+static int protopirate_storage_compare_time(const void *a, const void *b)
+{
+    const ProtoPirateStorageEntry *entry_a = a;
+    const ProtoPirateStorageEntry *entry_b = b;
+    if (entry_a->timestamp != entry_b->timestamp)
+    {
+        return entry_a->timestamp < entry_b->timestamp ? 1 : -1;
+    }
+    return protopirate_storage_compare_name(a, b);
+}
+
+// Grouped by protocol, newest first within a group
+static int protopirate_storage_compare_protocol(const void *a, const void *b)
+{
+    const char *name_a = furi_string_get_cstr(((const ProtoPirateStorageEntry *)a)->name);
+    const char *name_b = furi_string_get_cstr(((const ProtoPirateStorageEntry *)b)->name);
+    size_t length_a = protopirate_storage_protocol_length(name_a);
+    size_t length_b = protopirate_storage_protocol_length(name_b);
+
+    int result = strncmp(name_a, name_b, MIN(length_a, length_b));
+    if (result == 0 && length_a != length_b)
+    {
+        result = length_a < length_b ? -1 : 1;
+    }
+    return result ? result : protopirate_storage_compare_time(a, b);
+}
+
+static void protopirate_storage_index_sort()
+{
+    size_t count = ProtoPirateStorageEntryArray_size(protopirate_storage_entries);
+    if (protopirate_storage_sorted || count == 0)
+    {
+        protopirate_storage_sorted = true;
+        return;
+    }
+
+    int (*compare)(const void *, const void *) = protopirate_storage_compare_name;
+    if (protopirate_storage_sort == ProtoPirateStorageSortTime)
+    {
+        compare = protopirate_storage_compare_time;
+    }
+    else if (protopirate_storage_sort == ProtoPirateStorageSortProtocol)
+    {
+        compare = protopirate_storage_compare_protocol;
+    }
+
+    // m-array storage is contiguous
+    qsort(
+        ProtoPirateStorageEntryArray_get(protopirate_storage_entries, 0),
+        count,
+        sizeof(ProtoPirateStorageEntry),
+        compare);
+    protopirate_storage_sorted = true;
+}
+
+void protopirate_storage_set_sort(ProtoPirateStorageSort sort)
+{
+    protopirate_storage_lock();
+    if (protopirate_storage_sort != sort)
+    {
+        protopirate_storage_sort = sort;
+        protopirate_storage_sorted = false;
+        protopirate_storage_view_valid = false;
+    }
+    protopirate_storage_unlock();
+}
+
+ProtoPirateStorageSort protopirate_storage_get_sort()
+{
+    return protopirate_storage_sort;
+}
+
+static bool protopirate_storage_filter_match(const ProtoPirateStorageEntry *entry)
+{
+    const ProtoPirateStorageFilter *filter = &protopirate_storage_filter;
+    if ((entry->fields & filter->fields) != filter->fields)
+    {
+        return false;
+    }
+    if ((filter->fields & ProtoPirateCaptureFieldProtocol) &&
+        entry->protocol != filter->protocol)
+    {
+        return false;
+    }
+    return !(filter->fields & ProtoPirateCaptureFieldSerial) || entry->serial == filter->serial;
+}
+
+// Sorts if needed and maps listing positions to entries
+static void protopirate_storage_view_update()
+{
+    protopirate_storage_index_sort();
+    if (protopirate_storage_view_valid)
+    {
+        return;
+    }
+
+    ProtoPirateStorageViewArray_reset(protopirate_storage_view);
+    if (protopirate_storage_filter.fields)
+    {
+        for (size_t i = 0; i < ProtoPirateStorageEntryArray_size(protopirate_storage_entries); i++)
         {
-            uint32_array = malloc(sizeof(uint32_t) * uint32_array_size);
-            if (flipper_format_read_uint32(flipper_format, "RAW_Data", uint32_array, uint32_array_size))
+            if (protopirate_storage_filter_match(
+                    ProtoPirateStorageEntryArray_get(protopirate_storage_entries, i)))
             {
-                flipper_format_write_uint32(save_file, "RAW_Data", uint32_array, uint32_array_size);
+                ProtoPirateStorageViewArray_push_back(protopirate_storage_view, i);
             }
-            free(uint32_array);
         }
+    }
+    protopirate_storage_view_valid = true;
+}
 
-        // DataHi/DataLo for protocols with complex encoding
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "DataHi", &uint32_value, 1))
-        {
-            flipper_format_write_uint32(save_file, "DataHi", &uint32_value, 1);
-        }
+static size_t protopirate_storage_view_size()
+{
+    return protopirate_storage_filter.fields ?
+               ProtoPirateStorageViewArray_size(protopirate_storage_view) :
+               ProtoPirateStorageEntryArray_size(protopirate_storage_entries);
+}
 
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "DataLo", &uint32_value, 1))
+// Entry at a listing position, caller holds the lock
+static const ProtoPirateStorageEntry *protopirate_storage_view_get(uint32_t index)
+{
+    Storage *storage = furi_record_open(RECORD_STORAGE);
+    protopirate_storage_index_ensure(storage);
+    furi_record_close(RECORD_STORAGE);
+
+    protopirate_storage_view_update();
+    if (index >= protopirate_storage_view_size())
+    {
+        return NULL;
+    }
+
+    if (protopirate_storage_filter.fields)
+    {
+        index = *ProtoPirateStorageViewArray_get(protopirate_storage_view, index);
+    }
+    return ProtoPirateStorageEntryArray_get(protopirate_storage_entries, index);
+}
+
+void protopirate_storage_set_filter(const ProtoPirateStorageFilter *filter)
+{
+    protopirate_storage_lock();
+    if (filter)
+    {
+        protopirate_storage_filter = *filter;
+    }
+    else
+    {
+        memset(&protopirate_storage_filter, 0, sizeof(protopirate_storage_filter));
+    }
+    protopirate_storage_view_valid = false;
+    protopirate_storage_unlock();
+}
+
+bool protopirate_storage_get_filter(ProtoPirateStorageFilter *filter)
+{
+    protopirate_storage_lock();
+    *filter = protopirate_storage_filter;
+    protopirate_storage_unlock();
+    return filter->fields != 0;
+}
+
+void protopirate_storage_count_protocols(uint32_t *counts)
+{
+    Storage *storage = furi_record_open(RECORD_STORAGE);
+    protopirate_storage_lock();
+    protopirate_storage_index_ensure(storage);
+
+    memset(counts, 0, sizeof(uint32_t) * protopirate_protocol_registry.size);
+    for (size_t i = 0; i < ProtoPirateStorageEntryArray_size(protopirate_storage_entries); i++)
+    {
+        const ProtoPirateStorageEntry *entry =
+            ProtoPirateStorageEntryArray_get(protopirate_storage_entries, i);
+        if (entry->fields & ProtoPirateCaptureFieldProtocol)
         {
-            flipper_format_write_uint32(save_file, "DataLo", &uint32_value, 1);
+            counts[entry->protocol]++;
         }
+    }
 
-        // RawCnt for Kia V2
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "RawCnt", &uint32_value, 1))
+    protopirate_storage_unlock();
+    furi_record_close(RECORD_STORAGE);
+}
+
+void protopirate_storage_index_alloc()
+{
+    furi_assert(!protopirate_storage_mutex);
+    protopirate_storage_mutex = furi_mutex_alloc(FuriMutexTypeRecursive);
+    ProtoPirateStorageEntryArray_init(protopirate_storage_entries);
+    ProtoPirateStorageViewArray_init(protopirate_storage_view);
+    memset(&protopirate_storage_filter, 0, sizeof(protopirate_storage_filter));
+    ProtoPirateStorageCounterArray_init(protopirate_storage_counters);
+    protopirate_storage_index_valid = false;
+}
+
+void protopirate_storage_index_free()
+{
+    furi_assert(protopirate_storage_mutex);
+    protopirate_storage_index_clear();
+    ProtoPirateStorageEntryArray_clear(protopirate_storage_entries);
+    ProtoPirateStorageViewArray_clear(protopirate_storage_view);
+    ProtoPirateStorageCounterArray_clear(protopirate_storage_counters);
+    furi_mutex_free(protopirate_storage_mutex);
+    protopirate_storage_mutex = NULL;
+}
+
+bool protopirate_storage_init()
+{
+    Storage *storage = furi_record_open(RECORD_STORAGE);
+    bool result = storage_simply_mkdir(storage, PROTOPIRATE_APP_FOLDER);
+    furi_record_close(RECORD_STORAGE);
+    return result;
+}
+
+// Highest "<protocol>_<n>" in the index plus one, a single in-memory pass
+static uint32_t protopirate_storage_seed_counter(const char *protocol_name)
+{
+    size_t prefix_len = strlen(protocol_name);
+    uint32_t next = 0;
+
+    for (size_t i = 0; i < ProtoPirateStorageEntryArray_size(protopirate_storage_entries); i++)
+    {
+        const char *name = furi_string_get_cstr(
+            ProtoPirateStorageEntryArray_get(protopirate_storage_entries, i)->name);
+        if (strncmp(name, protocol_name, prefix_len) || name[prefix_len] != '_')
+            continue;
+
+        char *end;
+        uint32_t number = strtoul(name + prefix_len + 1, &end, 10);
+        if (end != name + prefix_len + 1 && !strcmp(end, PROTOPIRATE_APP_EXTENSION) &&
+            number >= next)
         {
-            flipper_format_write_uint32(save_file, "RawCnt", &uint32_value, 1);
+            next = number + 1;
         }
+    }
+
+    return next;
+}
+
+bool protopirate_storage_get_next_filename(
+    const char *protocol_name,
+    FuriString *out_filename)
+{
+    Storage *storage = furi_record_open(RECORD_STORAGE);
+    protopirate_storage_lock();
+    protopirate_storage_index_ensure(storage);
 
-        // Encrypted/Decrypted for Kia V3/V4
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "Encrypted", &uint32_value, 1))
+    ProtoPirateStorageCounter *counter = NULL;
+    for (size_t i = 0; i < ProtoPirateStorageCounterArray_size(protopirate_storage_counters); i++)
+    {
+        ProtoPirateStorageCounter *item =
+            ProtoPirateStorageCounterArray_get(protopirate_storage_counters, i);
+        if (furi_string_equal_str(item->protocol, protocol_name))
         {
-            flipper_format_write_uint32(save_file, "Encrypted", &uint32_value, 1);
+            counter = item;
+            break;
         }
+    }
+    if (!counter)
+    {
+        counter = ProtoPirateStorageCounterArray_push_raw(protopirate_storage_counters);
+        counter->protocol = furi_string_alloc_set_str(protocol_name);
+        counter->next = protopirate_storage_seed_counter(protocol_name);
+    }
+
+    // Numbers grow past 999 instead of failing. Nothing is probed here, the
+    // caller creates the file with FSOM_CREATE_NEW and asks again on a clash.
+    furi_string_printf(
+        out_filename,
+        "%s/%s_%03lu%s",
+        PROTOPIRATE_APP_FOLDER,
+        protocol_name,
+        counter->next++,
+        PROTOPIRATE_APP_EXTENSION);
+
+    protopirate_storage_unlock();
+    furi_record_close(RECORD_STORAGE);
+
+    return true;
+}
+
+bool protopirate_storage_seek_keys(FlipperFormat *flipper_format)
+{
+    static const char filetype[] = "Filetype:";
+    Stream *stream = flipper_format_get_raw_stream(flipper_format);
+
+    // Captures from history carry no header, files loaded from SD do
+    char head[sizeof(filetype) - 1];
+    stream_rewind(stream);
+    bool has_header = stream_read(stream, (uint8_t *)head, sizeof(head)) == sizeof(head) &&
+                      !memcmp(head, filetype, sizeof(head));
+    stream_rewind(stream);
+    if (!has_header)
+    {
+        return true;
+    }
+
+    FuriString *filetype_str = furi_string_alloc();
+    uint32_t version;
+    bool result = flipper_format_read_header(flipper_format, filetype_str, &version);
+    furi_string_free(filetype_str);
+    return result;
+}
 
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "Decrypted", &uint32_value, 1))
+// Streams the key/value lines of src after its header, if any, into dst
+static bool protopirate_storage_copy_keys(FlipperFormat *src, FlipperFormat *dst)
+{
+    if (!protopirate_storage_seek_keys(src))
+    {
+        return false;
+    }
+
+    Stream *src_stream = flipper_format_get_raw_stream(src);
+    size_t size = stream_size(src_stream) - stream_tell(src_stream);
+    return stream_copy(src_stream, flipper_format_get_raw_stream(dst), size) == size;
+}
+
+bool protopirate_storage_save_capture(
+    FlipperFormat *flipper_format,
+    const char *protocol_name,
+    FuriString *out_path)
+{
+
+    if (!protopirate_storage_init())
+    {
+        FURI_LOG_E(TAG, "Failed to create app folder");
+        return false;
+    }
+
+    FuriString *file_path = furi_string_alloc();
+    Storage *storage = furi_record_open(RECORD_STORAGE);
+    FlipperFormat *save_file = flipper_format_file_alloc(storage);
+    bool created = false;
+    bool result = false;
+
+    // Held until the new name is in the index, so no other save can take it
+    protopirate_storage_lock();
+
+    do
+    {
+        // Creating the file is the existence check, a name only collides
+        // when files appeared behind the index's back
+        for (uint8_t attempt = 0; attempt < PROTOPIRATE_STORAGE_NAME_ATTEMPTS && !created;
+             attempt++)
         {
-            flipper_format_write_uint32(save_file, "Decrypted", &uint32_value, 1);
+            protopirate_storage_get_next_filename(protocol_name, file_path);
+            created = flipper_format_file_open_new(save_file, furi_string_get_cstr(file_path));
         }
-
-        // Version for Kia V3/V4
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "Version", &uint32_value, 1))
+        if (!created)
         {
-            flipper_format_write_uint32(save_file, "Version", &uint32_value, 1);
+            FURI_LOG_E(TAG, "Failed to create file");
+            break;
         }
 
-        // BS byte for Ford
-        flipper_format_rewind(flipper_format);
-        if (flipper_format_read_uint32(flipper_format, "BS", &uint32_value, 1))
+        // Write standard SubGhz file header
+        if (!flipper_format_write_header_cstr(save_file, "Flipper SubGhz", 1))
         {
-            flipper_format_write_uint32(save_file, "BS", &uint32_value, 1);
+            FURI_LOG_E(TAG, "Failed to write header");
+            break;
         }
 
-        // Debug: Log what we saved
-        flipper_format_rewind(save_file);
-        FuriString *debug_str = furi_string_alloc();
-        uint32_t debug_bits;
-        uint32_t debug_version;
-        flipper_format_read_header(save_file, debug_str, &debug_version);
-        if (flipper_format_read_string(save_file, "Protocol", debug_str)) {
-            FURI_LOG_I(TAG, "Saved Protocol: %s", furi_string_get_cstr(debug_str));
-        }
-        flipper_format_rewind(save_file);
-        flipper_format_read_header(save_file, debug_str, &debug_version);
-        if (flipper_format_read_uint32(save_file, "Bit", &debug_bits, 1)) {
-            FURI_LOG_I(TAG, "Saved Bit count: %lu", debug_bits);
+        // Copy every key verbatim in one pass, whatever its type
+        if (!protopirate_storage_copy_keys(flipper_format, save_file))
+        {
+            FURI_LOG_E(TAG, "Failed to copy capture data");
+            break;
         }
-        furi_string_free(debug_str);
-
-        furi_string_free(string_value);
 
         if (out_path)
         {
@@ -307,10 +1071,24 @@ bool protopirate_storage_save_capture(
 
         result = true;
         FURI_LOG_I(TAG, "Saved capture to %s", furi_string_get_cstr(file_path));
-
     } while (false);
 
     flipper_format_free(save_file);
+    if (result)
+    {
+        uint32_t timestamp = 0;
+        storage_common_timestamp(storage, furi_string_get_cstr(file_path), &timestamp);
+        ProtoPirateStorageEntry *entry = protopirate_storage_index_push(
+            protopirate_storage_get_name(furi_string_get_cstr(file_path)), timestamp);
+        protopirate_storage_read_meta(flipper_format, entry);
+        protopirate_storage_index_append(storage, entry);
+    }
+    else if (created)
+    {
+        // Don't leave a truncated capture behind
+        storage_simply_remove(storage, furi_string_get_cstr(file_path));
+    }
+    protopirate_storage_unlock();
     furi_string_free(file_path);
     furi_record_close(RECORD_STORAGE);
 
@@ -320,28 +1098,37 @@ bool protopirate_storage_save_capture(
 uint32_t protopirate_storage_get_file_count()
 {
     Storage *storage = furi_record_open(RECORD_STORAGE);
-    File *dir = storage_file_alloc(storage);
-    FileInfo file_info;
-    uint32_t count = 0;
+    protopirate_storage_lock();
+    protopirate_storage_index_ensure(storage);
+    protopirate_storage_view_update();
+    uint32_t count = protopirate_storage_view_size();
+    protopirate_storage_unlock();
+    furi_record_close(RECORD_STORAGE);
 
-    if (storage_dir_open(dir, PROTOPIRATE_APP_FOLDER))
+    return count;
+}
+
+bool protopirate_storage_get_info_by_index(uint32_t index, ProtoPirateStorageInfo *out_info)
+{
+    furi_assert(out_info);
+
+    protopirate_storage_lock();
+    const ProtoPirateStorageEntry *entry = protopirate_storage_view_get(index);
+    if (entry)
     {
-        char name[256];
-        while (storage_dir_read(dir, &file_info, name, sizeof(name)))
-        {
-            if (!file_info_is_dir(&file_info) &&
-                strstr(name, PROTOPIRATE_APP_EXTENSION))
-            {
-                count++;
-            }
-        }
+        out_info->key = entry->key;
+        out_info->timestamp = entry->timestamp;
+        out_info->frequency = entry->frequency;
+        out_info->serial = entry->serial;
+        out_info->cnt = entry->cnt;
+        out_info->bits = entry->bits;
+        out_info->fields = entry->fields;
+        out_info->btn = entry->btn;
+        out_info->protocol = entry->protocol;
     }
+    protopirate_storage_unlock();
 
-    storage_dir_close(dir);
-    storage_file_free(dir);
-    furi_record_close(RECORD_STORAGE);
-
-    return count;
+    return entry != NULL;
 }
 
 bool protopirate_storage_get_file_by_index(
@@ -349,56 +1136,91 @@ bool protopirate_storage_get_file_by_index(
     FuriString *out_path,
     FuriString *out_name)
 {
+    protopirate_storage_lock();
+    const ProtoPirateStorageEntry *entry = protopirate_storage_view_get(index);
+    if (!entry)
+    {
+        protopirate_storage_unlock();
+        return false;
+    }
 
+    const char *name = furi_string_get_cstr(entry->name);
+    if (out_path)
+    {
+        furi_string_printf(out_path, "%s/%s", PROTOPIRATE_APP_FOLDER, name);
+    }
+    if (out_name)
+    {
+        // Remove extension for display
+        furi_string_set_str(out_name, name);
+        size_t dot = furi_string_search_rchar(out_name, '.', 0);
+        if (dot != FURI_STRING_FAILURE)
+            furi_string_left(out_name, dot);
+    }
+
+    protopirate_storage_unlock();
+    return true;
+}
+
+bool protopirate_storage_delete_file(const char *file_path)
+{
     Storage *storage = furi_record_open(RECORD_STORAGE);
-    File *dir = storage_file_alloc(storage);
-    FileInfo file_info;
-    uint32_t current_index = 0;
-    bool found = false;
+    protopirate_storage_lock();
+    bool result = storage_simply_remove(storage, file_path);
 
-    if (storage_dir_open(dir, PROTOPIRATE_APP_FOLDER))
+    if (result && protopirate_storage_index_valid)
     {
-        char name[256];
-        while (storage_dir_read(dir, &file_info, name, sizeof(name)))
+        const char *name = protopirate_storage_get_name(file_path);
+        for (size_t i = 0; i < ProtoPirateStorageEntryArray_size(protopirate_storage_entries); i++)
         {
-            if (!file_info_is_dir(&file_info) &&
-                strstr(name, PROTOPIRATE_APP_EXTENSION))
+            ProtoPirateStorageEntry entry =
+                *ProtoPirateStorageEntryArray_get(protopirate_storage_entries, i);
+            if (furi_string_equal_str(entry.name, name))
             {
-                if (current_index == index)
-                {
-                    if (out_path)
-                    {
-                        furi_string_printf(out_path, "%s/%s", PROTOPIRATE_APP_FOLDER, name);
-                    }
-                    if (out_name)
-                    {
-                        // Remove extension for display
-                        char *dot = strrchr(name, '.');
-                        if (dot)
-                            *dot = '\0';
-                        furi_string_set_str(out_name, name);
-                    }
-                    found = true;
-                    break;
-                }
-                current_index++;
+                protopirate_storage_index_tombstone(storage, &entry);
+                // Keeps the remaining entries in their sorted order
+                ProtoPirateStorageEntryArray_pop_at(&entry, protopirate_storage_entries, i);
+                furi_string_free(entry.name);
+                protopirate_storage_view_valid = false;
+                break;
             }
         }
     }
 
-    storage_dir_close(dir);
-    storage_file_free(dir);
+    protopirate_storage_unlock();
     furi_record_close(RECORD_STORAGE);
-
-    return found;
+    return result;
 }
 
-bool protopirate_storage_delete_file(const char *file_path)
+void protopirate_storage_update_counter(const char *file_path, uint8_t btn, uint32_t cnt)
 {
     Storage *storage = furi_record_open(RECORD_STORAGE);
-    bool result = storage_simply_remove(storage, file_path);
+    protopirate_storage_lock();
+
+    const char *name = protopirate_storage_get_name(file_path);
+    for (size_t i = 0;
+         protopirate_storage_index_valid &&
+         i < ProtoPirateStorageEntryArray_size(protopirate_storage_entries);
+         i++)
+    {
+        ProtoPirateStorageEntry *entry =
+            ProtoPirateStorageEntryArray_get(protopirate_storage_entries, i);
+        if (furi_string_equal_str(entry->name, name))
+        {
+            entry->btn = btn;
+            entry->cnt = cnt;
+            entry->fields |= ProtoPirateCaptureFieldBtn | ProtoPirateCaptureFieldCnt;
+            // The write moved the mtime, as a rescan would see it
+            storage_common_timestamp(storage, file_path, &entry->timestamp);
+            protopirate_storage_sorted = false;
+            protopirate_storage_view_valid = false;
+            protopirate_storage_index_update(storage, entry);
+            break;
+        }
+    }
+
+    protopirate_storage_unlock();
     furi_record_close(RECORD_STORAGE);
-    return result;
 }
 
 FlipperFormat *protopirate_storage_load_file(const char *file_path)
@@ -409,6 +1231,10 @@ FlipperFormat *protopirate_storage_load_file(const char *file_path)
     if (!flipper_format_file_open_existing(flipper_format, file_path))
     {
         FURI_LOG_E(TAG, "Failed to open file %s", file_path);
+        // Changed behind our back, e.g. over USB, rescan on next listing
+        protopirate_storage_lock();
+        protopirate_storage_index_valid = false;
+        protopirate_storage_unlock();
         flipper_format_free(flipper_format);
         furi_record_close(RECORD_STORAGE);
         return NULL;
@@ -4,10 +4,13 @@
 #include <furi.h>
 #include <storage/storage.h>
 #include <flipper_format/flipper_format.h>
+#include "protopirate_capture.h"
 
 #define PROTOPIRATE_APP_FOLDER EXT_PATH("subghz/protopirate")
 #define PROTOPIRATE_APP_EXTENSION ".sub"
 #define PROTOPIRATE_APP_FILE_VERSION 1
+// Receiver history kept across sessions, see protopirate_history_save
+#define PROTOPIRATE_HISTORY_SNAPSHOT_PATH PROTOPIRATE_APP_FOLDER "/.history"
 
 bool protopirate_storage_init();
 bool protopirate_storage_save_capture(
@@ -17,7 +20,64 @@ bool protopirate_storage_save_capture(
 bool protopirate_storage_get_next_filename(
     const char *protocol_name,
     FuriString *out_filename);
+typedef enum
+{
+    ProtoPirateStorageSortName,
+    ProtoPirateStorageSortProtocol,
+    ProtoPirateStorageSortTime,
+    ProtoPirateStorageSortNum,
+} ProtoPirateStorageSort;
+
 uint32_t protopirate_storage_get_file_count();
+// Index into the listing in the current sort order, O(1) once sorted
 bool protopirate_storage_get_file_by_index(uint32_t index, FuriString *out_path, FuriString *out_name);
+void protopirate_storage_set_sort(ProtoPirateStorageSort sort);
+ProtoPirateStorageSort protopirate_storage_get_sort();
+
+#define PROTOPIRATE_STORAGE_PROTOCOL_UNKNOWN 0xFF
+
+// Key fields of a capture as held by the index
+typedef struct
+{
+    uint64_t key;
+    uint32_t timestamp;
+    uint32_t frequency;
+    uint32_t serial;
+    uint32_t cnt;
+    uint16_t bits;
+    // ProtoPirateCaptureField bits of the values present
+    uint16_t fields;
+    uint8_t btn;
+    // Index into protopirate_protocol_registry, valid with ProtoPirateCaptureFieldProtocol
+    uint8_t protocol;
+} ProtoPirateStorageInfo;
+
+// Same position as protopirate_storage_get_file_by_index, without opening the file
+bool protopirate_storage_get_info_by_index(uint32_t index, ProtoPirateStorageInfo *out_info);
+
+// Restricts the listing to captures matching every field set in fields,
+// ProtoPirateCaptureFieldProtocol and/or ProtoPirateCaptureFieldSerial.
+// Answered from the index, no capture file is opened.
+typedef struct
+{
+    uint32_t fields;
+    // Index into protopirate_protocol_registry
+    uint8_t protocol;
+    uint32_t serial;
+} ProtoPirateStorageFilter;
+
+// NULL shows every capture again
+void protopirate_storage_set_filter(const ProtoPirateStorageFilter *filter);
+// Returns false when no filter is set
+bool protopirate_storage_get_filter(ProtoPirateStorageFilter *filter);
+// Indexed captures per protocol, counts holds protopirate_protocol_registry.size items
+void protopirate_storage_count_protocols(uint32_t *counts);
 bool protopirate_storage_delete_file(const char *file_path);
-FlipperFormat *protopirate_storage_load_file(const char *file_path);
\ No newline at end of file
+// Brings the indexed Btn and Cnt in line after they were written to the file
+void protopirate_storage_update_counter(const char *file_path, uint8_t btn, uint32_t cnt);
+FlipperFormat *protopirate_storage_load_file(const char *file_path);
+// Positions the raw stream on the first key, past the file header if any
+bool protopirate_storage_seek_keys(FlipperFormat *flipper_format);
+// Cached capture index, shared by all threads, lives for the app's lifetime
+void protopirate_storage_index_alloc();
+void protopirate_storage_index_free();
\ No newline at end of file
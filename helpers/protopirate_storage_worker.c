@@ -0,0 +1,246 @@
+// helpers/protopirate_storage_worker.c
+#include "protopirate_storage_worker.h"
+#include "protopirate_storage.h"
+#include "protopirate_archive.h"
+#include <toolbox/stream/stream.h>
+
+#define TAG "ProtoPirateStorageWorker"
+
+#define PROTOPIRATE_STORAGE_WORKER_QUEUE_SIZE 8
+#define PROTOPIRATE_STORAGE_WORKER_STACK_SIZE 2048
+
+// A record with data == NULL is a command, ProtoPirateStorageTargetFile
+// stops the thread
+typedef struct
+{
+    uint8_t *data;
+    uint32_t length;
+    ProtoPirateStorageTarget target;
+} ProtoPirateStorageRecord;
+
+struct ProtoPirateStorageWorker
+{
+    FuriThread *thread;
+    FuriMessageQueue *queue;
+    // Only touched by the worker thread
+    ProtoPirateArchive *archive;
+    ProtoPirateStorageWorkerCallback callback;
+    void *context;
+    uint32_t dropped;
+};
+
+static bool protopirate_storage_worker_write(
+    ProtoPirateStorageWorker *instance,
+    FlipperFormat *flipper_format,
+    const ProtoPirateStorageRecord *record)
+{
+    Stream *stream = flipper_format_get_raw_stream(flipper_format);
+    stream_clean(stream);
+    if (stream_write(stream, record->data, record->length) != record->length)
+    {
+        return false;
+    }
+    flipper_format_rewind(flipper_format);
+
+    if (record->target == ProtoPirateStorageTargetArchive)
+    {
+        if (!instance->archive)
+        {
+            instance->archive = protopirate_archive_create(NULL);
+        }
+        return instance->archive && protopirate_archive_append(instance->archive, flipper_format);
+    }
+
+    FuriString *protocol = furi_string_alloc();
+    if (!flipper_format_read_string(flipper_format, "Protocol", protocol))
+    {
+        furi_string_set_str(protocol, "Unknown");
+    }
+    bool result =
+        protopirate_storage_save_capture(flipper_format, furi_string_get_cstr(protocol), NULL);
+    furi_string_free(protocol);
+    return result;
+}
+
+static bool protopirate_storage_worker_command(
+    ProtoPirateStorageWorker *instance,
+    ProtoPirateStorageTarget command)
+{
+    if (command == ProtoPirateStorageTargetUnpack)
+    {
+        if (instance->archive)
+        {
+            protopirate_archive_close(instance->archive);
+            instance->archive = NULL;
+        }
+        return protopirate_archive_unpack_all(NULL);
+    }
+
+    if (!instance->archive)
+    {
+        instance->archive = protopirate_archive_create(NULL);
+    }
+    return instance->archive && protopirate_archive_pack_all(instance->archive, NULL);
+}
+
+static int32_t protopirate_storage_worker_thread(void *context)
+{
+    ProtoPirateStorageWorker *instance = context;
+    FlipperFormat *flipper_format = flipper_format_string_alloc();
+    ProtoPirateStorageRecord record;
+    bool running = true;
+
+    while (running &&
+           furi_message_queue_get(instance->queue, &record, FuriWaitForever) == FuriStatusOk)
+    {
+        // Take everything queued meanwhile as one batch, the archive index
+        // is written once per batch instead of once per record
+        bool archived = false;
+        do
+        {
+            if (!record.data && record.target == ProtoPirateStorageTargetFile)
+            {
+                running = false;
+                continue;
+            }
+
+            bool result;
+            if (record.data)
+            {
+                result = protopirate_storage_worker_write(instance, flipper_format, &record);
+                archived |= result && record.target == ProtoPirateStorageTargetArchive;
+                free(record.data);
+            }
+            else
+            {
+                // Leaves the session archive closed or synced
+                result = protopirate_storage_worker_command(instance, record.target);
+                archived = false;
+            }
+
+            if (!result)
+            {
+                FURI_LOG_E(TAG, "Failed to write record");
+            }
+            if (instance->callback)
+            {
+                instance->callback(record.target, result, instance->context);
+            }
+        } while (furi_message_queue_get(instance->queue, &record, 0) == FuriStatusOk);
+
+        if (archived)
+        {
+            protopirate_archive_sync(instance->archive);
+        }
+    }
+
+    if (instance->archive)
+    {
+        protopirate_archive_close(instance->archive);
+        instance->archive = NULL;
+    }
+    flipper_format_free(flipper_format);
+    return 0;
+}
+
+ProtoPirateStorageWorker *protopirate_storage_worker_alloc(void)
+{
+    ProtoPirateStorageWorker *instance = malloc(sizeof(ProtoPirateStorageWorker));
+    instance->queue = furi_message_queue_alloc(
+        PROTOPIRATE_STORAGE_WORKER_QUEUE_SIZE, sizeof(ProtoPirateStorageRecord));
+    instance->archive = NULL;
+    instance->callback = NULL;
+    instance->context = NULL;
+    instance->dropped = 0;
+    instance->thread = furi_thread_alloc_ex(
+        TAG,
+        PROTOPIRATE_STORAGE_WORKER_STACK_SIZE,
+        protopirate_storage_worker_thread,
+        instance);
+    furi_thread_start(instance->thread);
+    return instance;
+}
+
+void protopirate_storage_worker_free(ProtoPirateStorageWorker *instance)
+{
+    furi_assert(instance);
+
+    // Queued behind any pending records, so those are still written
+    ProtoPirateStorageRecord stop = {.data = NULL, .target = ProtoPirateStorageTargetFile};
+    furi_message_queue_put(instance->queue, &stop, FuriWaitForever);
+    furi_thread_join(instance->thread);
+    furi_thread_free(instance->thread);
+
+    furi_message_queue_free(instance->queue);
+    free(instance);
+}
+
+void protopirate_storage_worker_set_callback(
+    ProtoPirateStorageWorker *instance,
+    ProtoPirateStorageWorkerCallback callback,
+    void *context)
+{
+    furi_assert(instance);
+    instance->callback = callback;
+    instance->context = context;
+}
+
+bool protopirate_storage_worker_submit(
+    ProtoPirateStorageWorker *instance,
+    FlipperFormat *flipper_format,
+    ProtoPirateStorageTarget target)
+{
+    furi_assert(instance);
+    furi_assert(flipper_format);
+
+    if (!protopirate_storage_seek_keys(flipper_format))
+    {
+        return false;
+    }
+
+    Stream *stream = flipper_format_get_raw_stream(flipper_format);
+    ProtoPirateStorageRecord record = {
+        .length = stream_size(stream) - stream_tell(stream),
+        .target = target,
+    };
+    if (record.length == 0)
+    {
+        return false;
+    }
+
+    record.data = malloc(record.length);
+    if (stream_read(stream, record.data, record.length) != record.length ||
+        furi_message_queue_put(instance->queue, &record, 0) != FuriStatusOk)
+    {
+        free(record.data);
+        instance->dropped++;
+        FURI_LOG_W(TAG, "Record dropped, %lu so far", instance->dropped);
+        return false;
+    }
+
+    return true;
+}
+
+bool protopirate_storage_worker_run(
+    ProtoPirateStorageWorker *instance,
+    ProtoPirateStorageTarget command)
+{
+    furi_assert(instance);
+    furi_check(
+        command == ProtoPirateStorageTargetUnpack || command == ProtoPirateStorageTargetPack);
+
+    ProtoPirateStorageRecord record = {.data = NULL, .target = command};
+    return furi_message_queue_put(instance->queue, &record, 0) == FuriStatusOk;
+}
+
+uint32_t protopirate_storage_worker_get_pending(ProtoPirateStorageWorker *instance)
+{
+    furi_assert(instance);
+    return furi_message_queue_get_count(instance->queue);
+}
+
+uint32_t protopirate_storage_worker_get_dropped(ProtoPirateStorageWorker *instance)
+{
+    furi_assert(instance);
+    return instance->dropped;
+}
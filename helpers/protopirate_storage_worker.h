@@ -0,0 +1,51 @@
+// helpers/protopirate_storage_worker.h
+#pragma once
+
+#include <furi.h>
+#include <flipper_format/flipper_format.h>
+
+typedef enum
+{
+    ProtoPirateStorageTargetFile,
+    ProtoPirateStorageTargetArchive,
+    // Commands without a record, see protopirate_storage_worker_run
+    ProtoPirateStorageTargetUnpack,
+    ProtoPirateStorageTargetPack,
+} ProtoPirateStorageTarget;
+
+// Called on the worker thread once per record or command, after it hit the
+// SD card
+typedef void (*ProtoPirateStorageWorkerCallback)(
+    ProtoPirateStorageTarget target,
+    bool success,
+    void *context);
+
+// Owns a thread writing serialized captures from a bounded queue, so neither
+// the GUI nor the decode path waits on SD latency. The session archive is
+// opened by the worker on first use and closed when it is freed.
+typedef struct ProtoPirateStorageWorker ProtoPirateStorageWorker;
+
+ProtoPirateStorageWorker *protopirate_storage_worker_alloc(void);
+// Writes out everything still queued before stopping the thread
+void protopirate_storage_worker_free(ProtoPirateStorageWorker *instance);
+void protopirate_storage_worker_set_callback(
+    ProtoPirateStorageWorker *instance,
+    ProtoPirateStorageWorkerCallback callback,
+    void *context);
+
+// Copies the keys of flipper_format and returns at once. Returns false and
+// counts a drop when the queue is full.
+bool protopirate_storage_worker_submit(
+    ProtoPirateStorageWorker *instance,
+    FlipperFormat *flipper_format,
+    ProtoPirateStorageTarget target);
+
+// Queues an archive command behind pending records and returns at once.
+// Unpack closes the session archive first so its records are unpacked too,
+// Pack moves the listed captures into the session archive.
+bool protopirate_storage_worker_run(
+    ProtoPirateStorageWorker *instance,
+    ProtoPirateStorageTarget command);
+
+uint32_t protopirate_storage_worker_get_pending(ProtoPirateStorageWorker *instance);
+uint32_t protopirate_storage_worker_get_dropped(ProtoPirateStorageWorker *instance);
@@ -24,14 +24,24 @@ typedef enum
     // Custom events for scenes
     ProtoPirateCustomEventSceneReceiverUpdate,
     ProtoPirateCustomEventSceneSettingLock,
+    ProtoPirateCustomEventSceneSettingClearHistory,
+    ProtoPirateCustomEventSceneSettingExportHistory,
     // File management
     ProtoPirateCustomEventReceiverInfoSave,
+    ProtoPirateCustomEventReceiverInfoPin,
     ProtoPirateCustomEventSavedInfoDelete,
+    ProtoPirateCustomEventSavedInfoSameSerial,
     // Emulator
     ProtoPirateCustomEventSavedInfoEmulate,
     ProtoPirateCustomEventEmulateTransmit,
     ProtoPirateCustomEventEmulateStop,
     ProtoPirateCustomEventEmulateExit,
+    // Storage worker completions, kept clear of submenu indices sent as events
+    ProtoPirateCustomEventStorageSaved = 0x10000,
+    ProtoPirateCustomEventStorageFailed,
+    // Archive unpack or pack finished, the capture listing changed
+    ProtoPirateCustomEventStorageArchived,
+    ProtoPirateCustomEventStorageArchiveFailed,
 } ProtoPirateCustomEvent;
 
 typedef enum
@@ -56,6 +66,14 @@ typedef enum
     ProtoPirateHopperStateRSSITimeOut,
 } ProtoPirateHopperState;
 
+typedef enum
+{
+    // Hop frequencies only, on the Modulation setting
+    ProtoPirateHopperModulationPreset,
+    // Every frequency on both AM650 and FM476
+    ProtoPirateHopperModulationAmFm,
+} ProtoPirateHopperModulation;
+
 typedef enum
 {
     ProtoPirateRxKeyStateIDLE,
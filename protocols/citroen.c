@@ -69,6 +69,17 @@ const SubGhzProtocol citroen_protocol = {
     .encoder = &subghz_protocol_citroen_encoder,
 };
 
+const ProtoPirateDecoderExt citroen_protocol_decoder_ext = {
+    .protocol = &citroen_protocol,
+    .decoder_size = sizeof(SubGhzProtocolDecoderCitroen),
+    .generic_offset = offsetof(SubGhzProtocolDecoderCitroen, generic),
+    .timing = &subghz_protocol_citroen_const,
+    .feed_pulse = NULL,
+    .feed_batch = subghz_protocol_decoder_citroen_feed_batch,
+    .preamble = ProtoPiratePreambleShortHigh,
+    .is_idle = subghz_protocol_decoder_citroen_is_idle,
+};
+
 // ----------------- Allocation / Reset / Free -------------------
 
 void* subghz_protocol_decoder_citroen_alloc(SubGhzEnvironment* environment) {
@@ -91,6 +102,12 @@ void subghz_protocol_decoder_citroen_reset(void* context) {
     subghz_protocol_decoder_citroen_reset_internal(instance);
 }
 
+bool subghz_protocol_decoder_citroen_is_idle(void* context) {
+    furi_assert(context);
+    SubGhzProtocolDecoderCitroen* instance = context;
+    return instance->decoder.parser_step == CitroenDecoderStepReset;
+}
+
 // ----------------- Helper Functions -------------------
 
 static uint8_t reverse8(uint8_t byte) {
@@ -135,10 +152,10 @@ static bool subghz_protocol_citroen_parse_data(SubGhzProtocolDecoderCitroen* ins
 
 // ----------------- Decoder Feed -------------------
 
-void subghz_protocol_decoder_citroen_feed(void* context, bool level, uint32_t duration) {
-    furi_assert(context);
-    SubGhzProtocolDecoderCitroen* instance = context;
-
+static inline void subghz_protocol_decoder_citroen_step(
+    SubGhzProtocolDecoderCitroen* instance,
+    bool level,
+    uint32_t duration) {
     switch(instance->decoder.parser_step) {
     case CitroenDecoderStepReset:
         if(level && (DURATION_DIFF(duration, subghz_protocol_citroen_const.te_short) <
@@ -228,6 +245,26 @@ void subghz_protocol_decoder_citroen_feed(void* context, bool level, uint32_t du
     }
 }
 
+void subghz_protocol_decoder_citroen_feed(void* context, bool level, uint32_t duration) {
+    furi_assert(context);
+    subghz_protocol_decoder_citroen_step(context, level, duration);
+}
+
+void subghz_protocol_decoder_citroen_feed_batch(
+    void* context,
+    const LevelDuration* pairs,
+    const ProtoPiratePulse* pulses,
+    size_t count) {
+    furi_assert(context);
+    UNUSED(pulses);
+    SubGhzProtocolDecoderCitroen* instance = context;
+
+    for(size_t i = 0; i < count; i++) {
+        subghz_protocol_decoder_citroen_step(
+            instance, level_duration_get_level(pairs[i]), level_duration_get_duration(pairs[i]));
+    }
+}
+
 // ----------------- API -------------------
 
 uint8_t subghz_protocol_decoder_citroen_get_hash_data(void* context) {
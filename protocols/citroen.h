@@ -9,15 +9,23 @@
 #include <lib/subghz/blocks/generic.h>
 #include <lib/subghz/blocks/math.h>
 #include <flipper_format/flipper_format.h>
+#include "protocol_pulse.h"
 
 #define CITROEN_PROTOCOL_NAME "Citroen"
 
 extern const SubGhzProtocol citroen_protocol;
+extern const ProtoPirateDecoderExt citroen_protocol_decoder_ext;
 
 void* subghz_protocol_decoder_citroen_alloc(SubGhzEnvironment* environment);
 void subghz_protocol_decoder_citroen_free(void* context);
 void subghz_protocol_decoder_citroen_reset(void* context);
+bool subghz_protocol_decoder_citroen_is_idle(void* context);
 void subghz_protocol_decoder_citroen_feed(void* context, bool level, uint32_t duration);
+void subghz_protocol_decoder_citroen_feed_batch(
+    void* context,
+    const LevelDuration* pairs,
+    const ProtoPiratePulse* pulses,
+    size_t count);
 uint8_t subghz_protocol_decoder_citroen_get_hash_data(void* context);
 SubGhzProtocolStatus subghz_protocol_decoder_citroen_serialize(
     void* context,
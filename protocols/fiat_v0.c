@@ -66,6 +66,17 @@ const SubGhzProtocol fiat_protocol_v0 = {
     .encoder = &subghz_protocol_fiat_v0_encoder,
 };
 
+const ProtoPirateDecoderExt fiat_protocol_v0_decoder_ext = {
+    .protocol = &fiat_protocol_v0,
+    .decoder_size = sizeof(SubGhzProtocolDecoderFiatV0),
+    .generic_offset = offsetof(SubGhzProtocolDecoderFiatV0, generic),
+    .timing = &subghz_protocol_fiat_v0_const,
+    .feed_pulse = NULL,
+    .feed_batch = subghz_protocol_decoder_fiat_v0_feed_batch,
+    .preamble = ProtoPiratePreambleShortHigh,
+    .is_idle = subghz_protocol_decoder_fiat_v0_is_idle,
+};
+
 void* subghz_protocol_decoder_fiat_v0_alloc(SubGhzEnvironment* environment) {
     UNUSED(environment);
     SubGhzProtocolDecoderFiatV0* instance = malloc(sizeof(SubGhzProtocolDecoderFiatV0));
@@ -97,9 +108,16 @@ void subghz_protocol_decoder_fiat_v0_reset(void* context) {
     instance->manchester_state = ManchesterStateMid1;
 }
 
-void subghz_protocol_decoder_fiat_v0_feed(void* context, bool level, uint32_t duration) {
+bool subghz_protocol_decoder_fiat_v0_is_idle(void* context) {
     furi_assert(context);
     SubGhzProtocolDecoderFiatV0* instance = context;
+    return instance->decoder_state == FiatV0DecoderStepReset;
+}
+
+static inline void subghz_protocol_decoder_fiat_v0_step(
+    SubGhzProtocolDecoderFiatV0* instance,
+    bool level,
+    uint32_t duration) {
     uint32_t te_short = (uint32_t)subghz_protocol_fiat_v0_const.te_short;
     uint32_t te_long = (uint32_t)subghz_protocol_fiat_v0_const.te_long;
     uint32_t te_delta = (uint32_t)subghz_protocol_fiat_v0_const.te_delta;
@@ -272,6 +290,26 @@ void subghz_protocol_decoder_fiat_v0_feed(void* context, bool level, uint32_t du
     }
 }
 
+void subghz_protocol_decoder_fiat_v0_feed(void* context, bool level, uint32_t duration) {
+    furi_assert(context);
+    subghz_protocol_decoder_fiat_v0_step(context, level, duration);
+}
+
+void subghz_protocol_decoder_fiat_v0_feed_batch(
+    void* context,
+    const LevelDuration* pairs,
+    const ProtoPiratePulse* pulses,
+    size_t count) {
+    furi_assert(context);
+    UNUSED(pulses);
+    SubGhzProtocolDecoderFiatV0* instance = context;
+
+    for(size_t i = 0; i < count; i++) {
+        subghz_protocol_decoder_fiat_v0_step(
+            instance, level_duration_get_level(pairs[i]), level_duration_get_duration(pairs[i]));
+    }
+}
+
 uint8_t subghz_protocol_decoder_fiat_v0_get_hash_data(void* context) {
     furi_assert(context);
     SubGhzProtocolDecoderFiatV0* instance = context;
@@ -9,17 +9,25 @@
 #include <lib/subghz/blocks/math.h>
 #include <lib/toolbox/manchester_decoder.h>
 #include <flipper_format/flipper_format.h>
+#include "protocol_pulse.h"
 
 #define FIAT_PROTOCOL_V0_NAME "Fiat V0"
 
 typedef struct SubGhzProtocolDecoderFiatV0 SubGhzProtocolDecoderFiatV0;
 
 extern const SubGhzProtocol fiat_protocol_v0;
+extern const ProtoPirateDecoderExt fiat_protocol_v0_decoder_ext;
 
 void* subghz_protocol_decoder_fiat_v0_alloc(SubGhzEnvironment* environment);
 void subghz_protocol_decoder_fiat_v0_free(void* context);
 void subghz_protocol_decoder_fiat_v0_reset(void* context);
+bool subghz_protocol_decoder_fiat_v0_is_idle(void* context);
 void subghz_protocol_decoder_fiat_v0_feed(void* context, bool level, uint32_t duration);
+void subghz_protocol_decoder_fiat_v0_feed_batch(
+    void* context,
+    const LevelDuration* pairs,
+    const ProtoPiratePulse* pulses,
+    size_t count);
 uint8_t subghz_protocol_decoder_fiat_v0_get_hash_data(void* context);
 SubGhzProtocolStatus subghz_protocol_decoder_fiat_v0_serialize(
     void* context,
@@ -78,6 +78,18 @@ const SubGhzProtocol ford_protocol_v0 = {
     .encoder = &subghz_protocol_ford_v0_encoder,
 };
 
+const ProtoPirateDecoderExt ford_protocol_v0_decoder_ext = {
+    .protocol = &ford_protocol_v0,
+    .decoder_size = sizeof(SubGhzProtocolDecoderFordV0),
+    .generic_offset = offsetof(SubGhzProtocolDecoderFordV0, generic),
+    .payload_offset = offsetof(SubGhzProtocolDecoderFordV0, key2),
+    .payload_size = sizeof(uint16_t),
+    .timing = &subghz_protocol_ford_v0_const,
+    .feed_pulse = subghz_protocol_decoder_ford_v0_feed_pulse,
+    .preamble = ProtoPiratePreambleShortHigh,
+    .is_idle = subghz_protocol_decoder_ford_v0_is_idle,
+};
+
 static void ford_v0_add_bit(SubGhzProtocolDecoderFordV0 *instance, bool bit)
 {
     uint32_t low = (uint32_t)instance->data_low;
@@ -213,20 +225,28 @@ void subghz_protocol_decoder_ford_v0_reset(void *context)
     instance->count = 0;
 }
 
-void subghz_protocol_decoder_ford_v0_feed(void *context, bool level, uint32_t duration)
+bool subghz_protocol_decoder_ford_v0_is_idle(void *context)
+{
+    furi_assert(context);
+    SubGhzProtocolDecoderFordV0 *instance = context;
+    return instance->decoder.parser_step == FordV0DecoderStepReset;
+}
+
+void subghz_protocol_decoder_ford_v0_feed_pulse(
+    void *context,
+    bool level,
+    uint32_t duration,
+    ProtoPiratePulse pulse)
 {
     furi_assert(context);
     SubGhzProtocolDecoderFordV0 *instance = context;
 
-    uint32_t te_short = subghz_protocol_ford_v0_const.te_short;
-    uint32_t te_long = subghz_protocol_ford_v0_const.te_long;
-    uint32_t te_delta = subghz_protocol_ford_v0_const.te_delta;
     uint32_t gap_threshold = 3500;
 
     switch (instance->decoder.parser_step)
     {
     case FordV0DecoderStepReset:
-        if (level && (DURATION_DIFF(duration, te_short) < te_delta))
+        if (level && (pulse == ProtoPiratePulseShort))
         {
             instance->data_low = 0;
             instance->data_high = 0;
@@ -241,7 +261,7 @@ void subghz_protocol_decoder_ford_v0_feed(void *context, bool level, uint32_t du
     case FordV0DecoderStepPreamble:
         if (!level)
         {
-            if (DURATION_DIFF(duration, te_long) < te_delta)
+            if (pulse == ProtoPiratePulseLong)
             {
                 instance->decoder.te_last = duration;
                 instance->decoder.parser_step = FordV0DecoderStepPreambleCheck;
@@ -256,13 +276,13 @@ void subghz_protocol_decoder_ford_v0_feed(void *context, bool level, uint32_t du
     case FordV0DecoderStepPreambleCheck:
         if (level)
         {
-            if (DURATION_DIFF(duration, te_long) < te_delta)
+            if (pulse == ProtoPiratePulseLong)
             {
                 instance->header_count++;
                 instance->decoder.te_last = duration;
                 instance->decoder.parser_step = FordV0DecoderStepPreamble;
             }
-            else if (DURATION_DIFF(duration, te_short) < te_delta)
+            else if (pulse == ProtoPiratePulseShort)
             {
                 instance->decoder.parser_step = FordV0DecoderStepGap;
             }
@@ -291,11 +311,11 @@ void subghz_protocol_decoder_ford_v0_feed(void *context, bool level, uint32_t du
     {
         ManchesterEvent event;
 
-        if (DURATION_DIFF(duration, te_short) < te_delta)
+        if (pulse == ProtoPiratePulseShort)
         {
             event = level ? ManchesterEventShortLow : ManchesterEventShortHigh;
         }
-        else if (DURATION_DIFF(duration, te_long) < te_delta)
+        else if (pulse == ProtoPiratePulseLong)
         {
             event = level ? ManchesterEventLongLow : ManchesterEventLongHigh;
         }
@@ -336,6 +356,12 @@ void subghz_protocol_decoder_ford_v0_feed(void *context, bool level, uint32_t du
     }
 }
 
+void subghz_protocol_decoder_ford_v0_feed(void *context, bool level, uint32_t duration)
+{
+    subghz_protocol_decoder_ford_v0_feed_pulse(
+        context, level, duration, protopirate_pulse_classify(&subghz_protocol_ford_v0_const, duration));
+}
+
 uint8_t subghz_protocol_decoder_ford_v0_get_hash_data(void *context)
 {
     furi_assert(context);
@@ -9,16 +9,24 @@
 #include <lib/subghz/blocks/generic.h>
 #include <lib/subghz/blocks/math.h>
 #include <flipper_format/flipper_format.h>
+#include "protocol_pulse.h"
 #include <lib/toolbox/manchester_decoder.h>
 
 #define FORD_PROTOCOL_V0_NAME "Ford V0"
 
 extern const SubGhzProtocol ford_protocol_v0;
+extern const ProtoPirateDecoderExt ford_protocol_v0_decoder_ext;
 
 void* subghz_protocol_decoder_ford_v0_alloc(SubGhzEnvironment* environment);
 void subghz_protocol_decoder_ford_v0_free(void* context);
 void subghz_protocol_decoder_ford_v0_reset(void* context);
+bool subghz_protocol_decoder_ford_v0_is_idle(void* context);
 void subghz_protocol_decoder_ford_v0_feed(void* context, bool level, uint32_t duration);
+void subghz_protocol_decoder_ford_v0_feed_pulse(
+    void* context,
+    bool level,
+    uint32_t duration,
+    ProtoPiratePulse pulse);
 uint8_t subghz_protocol_decoder_ford_v0_get_hash_data(void* context);
 SubGhzProtocolStatus subghz_protocol_decoder_ford_v0_serialize(
     void* context,
@@ -59,6 +59,17 @@ const SubGhzProtocol honda_protocol_v0 = {
     .encoder = &honda_protocol_v0_encoder,
 };
 
+const ProtoPirateDecoderExt honda_protocol_v0_decoder_ext = {
+    .protocol = &honda_protocol_v0,
+    .decoder_size = sizeof(SubGhzProtocolDecoderHondaV0),
+    .generic_offset = offsetof(SubGhzProtocolDecoderHondaV0, generic),
+    .timing = &honda_protocol_v0_const,
+    .feed_pulse = NULL,
+    // Placeholder decoder, feed does nothing yet
+    .preamble = ProtoPiratePreambleNever,
+    .is_idle = NULL,
+};
+
 void* honda_protocol_decoder_v0_alloc(SubGhzEnvironment* environment)
 {
     UNUSED(environment);
@@ -9,6 +9,7 @@
 #include <lib/subghz/blocks/generic.h>
 #include <lib/subghz/blocks/math.h>
 #include <flipper_format/flipper_format.h>
+#include "protocol_pulse.h"
 
 #define HONDA_PROTOCOL_V0_NAME "Honda V0"
 
@@ -18,6 +19,7 @@ typedef struct SubGhzProtocolEncoderHondaV0 SubGhzProtocolEncoderHondaV0;
 extern const SubGhzProtocolDecoder honda_protocol_v0_decoder;
 extern const SubGhzProtocolEncoder honda_protocol_v0_encoder;
 extern const SubGhzProtocol honda_protocol_v0;
+extern const ProtoPirateDecoderExt honda_protocol_v0_decoder_ext;
 
 void* honda_protocol_decoder_v0_alloc(SubGhzEnvironment* environment);
 void honda_protocol_decoder_v0_free(void* context);
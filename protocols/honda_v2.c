@@ -1,4 +1,5 @@
 #include "honda_v2.h"
+#include "protocol_manchester.h"
 
 #define TAG "HondaV2"
 
@@ -78,6 +79,16 @@ const SubGhzProtocol honda_protocol_v2 = {
     .encoder = &honda_protocol_v2_encoder,
 };
 
+const ProtoPirateDecoderExt honda_protocol_v2_decoder_ext = {
+    .protocol = &honda_protocol_v2,
+    .decoder_size = sizeof(SubGhzProtocolDecoderHondaV2),
+    .generic_offset = offsetof(SubGhzProtocolDecoderHondaV2, generic),
+    .timing = &honda_protocol_v2_const,
+    .feed_pulse = honda_protocol_decoder_v2_feed_pulse,
+    .preamble = ProtoPiratePreambleLongHigh,
+    .is_idle = honda_protocol_decoder_v2_is_idle,
+};
+
 // Helper function to add raw bits
 static void honda_v2_add_raw_bit(SubGhzProtocolDecoderHondaV2* instance, bool bit)
 {
@@ -97,14 +108,6 @@ static void honda_v2_add_raw_bit(SubGhzProtocolDecoderHondaV2* instance, bool bi
     }
 }
 
-// Helper function to get raw bit
-static inline bool honda_v2_get_raw_bit(SubGhzProtocolDecoderHondaV2* instance, uint16_t idx)
-{
-    uint16_t byte_idx = idx / 8;
-    uint8_t bit_idx = 7 - (idx % 8);
-    return (instance->raw_bits[byte_idx] >> bit_idx) & 1;
-}
-
 // Manchester decode function (Honda KR5V2X uses Manchester encoding)
 static bool honda_v2_manchester_decode(SubGhzProtocolDecoderHondaV2* instance)
 {
@@ -113,43 +116,14 @@ static bool honda_v2_manchester_decode(SubGhzProtocolDecoderHondaV2* instance)
         return false;
     }
 
-    uint16_t best_bits = 0;
     uint64_t best_data = 0;
-
-    for (uint16_t offset = 0; offset < 8; offset++)
-    {
-        uint64_t data = 0;
-        uint16_t decoded_bits = 0;
-
-        for (uint16_t i = offset; i + 1 < instance->raw_bit_count && decoded_bits < 64; i += 2)
-        {
-            bool bit1 = honda_v2_get_raw_bit(instance, i);
-            bool bit2 = honda_v2_get_raw_bit(instance, i + 1);
-
-            uint8_t two_bits = (bit1 << 1) | bit2;
-
-            if (two_bits == 0x02)  // 01 = 1
-            {
-                data = (data << 1) | 1;
-                decoded_bits++;
-            }
-            else if (two_bits == 0x01)  // 10 = 0
-            {
-                data = (data << 1);
-                decoded_bits++;
-            }
-            else
-            {
-                break;
-            }
-        }
-
-        if (decoded_bits > best_bits)
-        {
-            best_bits = decoded_bits;
-            best_data = data;
-        }
-    }
+    uint16_t best_bits = protopirate_manchester_decode_best(
+        instance->raw_bits,
+        instance->raw_bit_count,
+        64,
+        ProtoPirateManchesterOneIsHighLow,
+        &best_data,
+        NULL);
 
     instance->decoder.decode_data = best_data;
     instance->decoder.decode_count_bit = best_bits;
@@ -186,8 +160,19 @@ void honda_protocol_decoder_v2_reset(void* context)
     memset(instance->raw_bits, 0, sizeof(instance->raw_bits));
 }
 
+bool honda_protocol_decoder_v2_is_idle(void* context)
+{
+    furi_assert(context);
+    SubGhzProtocolDecoderHondaV2* instance = context;
+    return instance->decoder.parser_step == HondaV2DecoderStepReset;
+}
+
 // Main decoder feed function
-void honda_protocol_decoder_v2_feed(void* context, bool level, uint32_t duration)
+void honda_protocol_decoder_v2_feed_pulse(
+    void* context,
+    bool level,
+    uint32_t duration,
+    ProtoPiratePulse pulse)
 {
     furi_assert(context);
     SubGhzProtocolDecoderHondaV2* instance = context;
@@ -195,8 +180,7 @@ void honda_protocol_decoder_v2_feed(void* context, bool level, uint32_t duration
     switch (instance->decoder.parser_step)
     {
     case HondaV2DecoderStepReset:
-        if ((level) && (DURATION_DIFF(duration, honda_protocol_v2_const.te_long) <
-                        honda_protocol_v2_const.te_delta))
+        if ((level) && (pulse == ProtoPiratePulseLong))
         {
             instance->decoder.parser_step = HondaV2DecoderStepCheckPreamble;
             instance->decoder.te_last = duration;
@@ -207,15 +191,13 @@ void honda_protocol_decoder_v2_feed(void* context, bool level, uint32_t duration
     case HondaV2DecoderStepCheckPreamble:
         if (level)
         {
-            if (DURATION_DIFF(duration, honda_protocol_v2_const.te_long) <
-                honda_protocol_v2_const.te_delta)
+            if (pulse == ProtoPiratePulseLong)
             {
                 instance->decoder.te_last = duration;
                 instance->header_count++;
             }
             else if (
-                DURATION_DIFF(duration, honda_protocol_v2_const.te_short) <
-                honda_protocol_v2_const.te_delta)
+                pulse == ProtoPiratePulseShort)
             {
                 instance->decoder.te_last = duration;
             }
@@ -226,14 +208,12 @@ void honda_protocol_decoder_v2_feed(void* context, bool level, uint32_t duration
         }
         else
         {
-            if (DURATION_DIFF(duration, honda_protocol_v2_const.te_long) <
-                honda_protocol_v2_const.te_delta)
+            if (pulse == ProtoPiratePulseLong)
             {
                 instance->header_count++;
             }
             else if (
-                DURATION_DIFF(duration, honda_protocol_v2_const.te_short) <
-                honda_protocol_v2_const.te_delta)
+                pulse == ProtoPiratePulseShort)
             {
                 if (instance->header_count > 8 &&
                     DURATION_DIFF(instance->decoder.te_last, honda_protocol_v2_const.te_short) <
@@ -273,14 +253,12 @@ void honda_protocol_decoder_v2_feed(void* context, bool level, uint32_t duration
         }
 
         int num_bits = 0;
-        if (DURATION_DIFF(duration, honda_protocol_v2_const.te_short) <
-            honda_protocol_v2_const.te_delta)
+        if (pulse == ProtoPiratePulseShort)
         {
             num_bits = 1;
         }
         else if (
-            DURATION_DIFF(duration, honda_protocol_v2_const.te_long) <
-            honda_protocol_v2_const.te_delta)
+            pulse == ProtoPiratePulseLong)
         {
             num_bits = 2;
         }
@@ -299,6 +277,12 @@ void honda_protocol_decoder_v2_feed(void* context, bool level, uint32_t duration
     }
 }
 
+void honda_protocol_decoder_v2_feed(void* context, bool level, uint32_t duration)
+{
+    honda_protocol_decoder_v2_feed_pulse(
+        context, level, duration, protopirate_pulse_classify(&honda_protocol_v2_const, duration));
+}
+
 // Get hash data for identification
 uint8_t honda_protocol_decoder_v2_get_hash_data(void* context)
 {
@@ -9,6 +9,7 @@
 #include <lib/subghz/blocks/generic.h>
 #include <lib/subghz/blocks/math.h>
 #include <flipper_format/flipper_format.h>
+#include "protocol_pulse.h"
 
 #define HONDA_PROTOCOL_V2_NAME "Honda V2"
 
@@ -18,11 +19,18 @@ typedef struct SubGhzProtocolEncoderHondaV2 SubGhzProtocolEncoderHondaV2;
 extern const SubGhzProtocolDecoder honda_protocol_v2_decoder;
 extern const SubGhzProtocolEncoder honda_protocol_v2_encoder;
 extern const SubGhzProtocol honda_protocol_v2;
+extern const ProtoPirateDecoderExt honda_protocol_v2_decoder_ext;
 
 void* honda_protocol_decoder_v2_alloc(SubGhzEnvironment* environment);
 void honda_protocol_decoder_v2_free(void* context);
 void honda_protocol_decoder_v2_reset(void* context);
+bool honda_protocol_decoder_v2_is_idle(void* context);
 void honda_protocol_decoder_v2_feed(void* context, bool level, uint32_t duration);
+void honda_protocol_decoder_v2_feed_pulse(
+    void* context,
+    bool level,
+    uint32_t duration,
+    ProtoPiratePulse pulse);
 uint8_t honda_protocol_decoder_v2_get_hash_data(void* context);
 SubGhzProtocolStatus honda_protocol_decoder_v2_serialize(
     void* context,
@@ -77,6 +77,16 @@ const SubGhzProtocol hyundai_protocol_v0 = {
     .encoder = &subghz_protocol_hyundai_encoder,
 };
 
+const ProtoPirateDecoderExt hyundai_protocol_v0_decoder_ext = {
+    .protocol = &hyundai_protocol_v0,
+    .decoder_size = sizeof(SubGhzProtocolDecoderHyundai),
+    .generic_offset = offsetof(SubGhzProtocolDecoderHyundai, generic),
+    .timing = &subghz_protocol_hyundai_const,
+    .feed_pulse = NULL,
+    .preamble = ProtoPiratePreambleShortHigh,
+    .is_idle = subghz_protocol_decoder_hyundai_is_idle,
+};
+
 // Encoder implementation
 void *subghz_protocol_encoder_hyundai_alloc(SubGhzEnvironment *environment)
 {
@@ -354,6 +364,13 @@ void subghz_protocol_decoder_hyundai_reset(void *context)
     instance->decoder.parser_step = HyundaiDecoderStepReset;
 }
 
+bool subghz_protocol_decoder_hyundai_is_idle(void *context)
+{
+    furi_assert(context);
+    SubGhzProtocolDecoderHyundai *instance = context;
+    return instance->decoder.parser_step == HyundaiDecoderStepReset;
+}
+
 void subghz_protocol_decoder_hyundai_feed(void *context, bool level, uint32_t duration)
 {
     furi_assert(context);
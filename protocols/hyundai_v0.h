@@ -9,6 +9,7 @@
 #include <lib/subghz/blocks/generic.h>
 #include <lib/subghz/blocks/math.h>
 #include <flipper_format/flipper_format.h>
+#include "protocol_pulse.h"
 
 #define HYUNDAI_PROTOCOL_V0_NAME "Hyundai V0"
 
@@ -18,10 +19,12 @@ typedef struct SubGhzProtocolEncoderHyundai SubGhzProtocolEncoderHyundai;
 extern const SubGhzProtocolDecoder subghz_protocol_hyundai_decoder;
 extern const SubGhzProtocolEncoder subghz_protocol_hyundai_encoder;
 extern const SubGhzProtocol hyundai_protocol_v0;
+extern const ProtoPirateDecoderExt hyundai_protocol_v0_decoder_ext;
 
 void* subghz_protocol_decoder_hyundai_alloc(SubGhzEnvironment* environment);
 void subghz_protocol_decoder_hyundai_free(void* context);
 void subghz_protocol_decoder_hyundai_reset(void* context);
+bool subghz_protocol_decoder_hyundai_is_idle(void* context);
 void subghz_protocol_decoder_hyundai_feed(void* context, bool level, uint32_t duration);
 uint8_t subghz_protocol_decoder_hyundai_get_hash_data(void* context);
 SubGhzProtocolStatus subghz_protocol_decoder_hyundai_serialize(
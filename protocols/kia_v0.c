@@ -77,6 +77,17 @@ const SubGhzProtocol kia_protocol_v0 = {
     .encoder = &subghz_protocol_kia_encoder,
 };
 
+const ProtoPirateDecoderExt kia_protocol_v0_decoder_ext = {
+    .protocol = &kia_protocol_v0,
+    .decoder_size = sizeof(SubGhzProtocolDecoderKIA),
+    .generic_offset = offsetof(SubGhzProtocolDecoderKIA, generic),
+    .timing = &subghz_protocol_kia_const,
+    .feed_pulse = subghz_protocol_decoder_kia_feed_pulse,
+    .feed_batch = subghz_protocol_decoder_kia_feed_batch,
+    .preamble = ProtoPiratePreambleShortHigh,
+    .is_idle = subghz_protocol_decoder_kia_is_idle,
+};
+
 // Encoder implementation
 void *subghz_protocol_encoder_kia_alloc(SubGhzEnvironment *environment)
 {
@@ -385,15 +396,23 @@ void subghz_protocol_decoder_kia_reset(void *context)
     instance->decoder.parser_step = KIADecoderStepReset;
 }
 
-void subghz_protocol_decoder_kia_feed(void *context, bool level, uint32_t duration)
+bool subghz_protocol_decoder_kia_is_idle(void *context)
 {
     furi_assert(context);
     SubGhzProtocolDecoderKIA *instance = context;
+    return instance->decoder.parser_step == KIADecoderStepReset;
+}
 
+static inline void subghz_protocol_decoder_kia_step(
+    SubGhzProtocolDecoderKIA *instance,
+    bool level,
+    uint32_t duration,
+    ProtoPiratePulse pulse)
+{
     switch (instance->decoder.parser_step)
     {
     case KIADecoderStepReset:
-        if ((level) && (DURATION_DIFF(duration, subghz_protocol_kia_const.te_short) < subghz_protocol_kia_const.te_delta))
+        if ((level) && (pulse == ProtoPiratePulseShort))
         {
             instance->decoder.parser_step = KIADecoderStepCheckPreambula;
             instance->decoder.te_last = duration;
@@ -403,8 +422,7 @@ void subghz_protocol_decoder_kia_feed(void *context, bool level, uint32_t durati
     case KIADecoderStepCheckPreambula:
         if (level)
         {
-            if ((DURATION_DIFF(duration, subghz_protocol_kia_const.te_short) < subghz_protocol_kia_const.te_delta) ||
-                (DURATION_DIFF(duration, subghz_protocol_kia_const.te_long) < subghz_protocol_kia_const.te_delta))
+            if ((pulse == ProtoPiratePulseShort) || (pulse == ProtoPiratePulseLong))
             {
                 instance->decoder.te_last = duration;
             }
@@ -414,14 +432,14 @@ void subghz_protocol_decoder_kia_feed(void *context, bool level, uint32_t durati
             }
         }
         else if (
-            (DURATION_DIFF(duration, subghz_protocol_kia_const.te_short) < subghz_protocol_kia_const.te_delta) &&
+            (pulse == ProtoPiratePulseShort) &&
             (DURATION_DIFF(instance->decoder.te_last, subghz_protocol_kia_const.te_short) < subghz_protocol_kia_const.te_delta))
         {
             instance->header_count++;
             break;
         }
         else if (
-            (DURATION_DIFF(duration, subghz_protocol_kia_const.te_long) < subghz_protocol_kia_const.te_delta) &&
+            (pulse == ProtoPiratePulseLong) &&
             (DURATION_DIFF(instance->decoder.te_last, subghz_protocol_kia_const.te_long) < subghz_protocol_kia_const.te_delta))
         {
             if (instance->header_count > 15)
@@ -484,7 +502,7 @@ void subghz_protocol_decoder_kia_feed(void *context, bool level, uint32_t durati
         if (!level)
         {
             if ((DURATION_DIFF(instance->decoder.te_last, subghz_protocol_kia_const.te_short) < subghz_protocol_kia_const.te_delta) &&
-                (DURATION_DIFF(duration, subghz_protocol_kia_const.te_short) < subghz_protocol_kia_const.te_delta))
+                (pulse == ProtoPiratePulseShort))
             {
                 subghz_protocol_blocks_add_bit(&instance->decoder, 0);
                 if (instance->decoder.decode_count_bit % 10 == 0) {
@@ -494,7 +512,7 @@ void subghz_protocol_decoder_kia_feed(void *context, bool level, uint32_t durati
             }
             else if (
                 (DURATION_DIFF(instance->decoder.te_last, subghz_protocol_kia_const.te_long) < subghz_protocol_kia_const.te_delta) &&
-                (DURATION_DIFF(duration, subghz_protocol_kia_const.te_long) < subghz_protocol_kia_const.te_delta))
+                (pulse == ProtoPiratePulseLong))
             {
                 subghz_protocol_blocks_add_bit(&instance->decoder, 1);
                 if (instance->decoder.decode_count_bit % 10 == 0) {
@@ -517,6 +535,41 @@ void subghz_protocol_decoder_kia_feed(void *context, bool level, uint32_t durati
     }
 }
 
+void subghz_protocol_decoder_kia_feed_pulse(
+    void *context,
+    bool level,
+    uint32_t duration,
+    ProtoPiratePulse pulse)
+{
+    furi_assert(context);
+    subghz_protocol_decoder_kia_step(context, level, duration, pulse);
+}
+
+void subghz_protocol_decoder_kia_feed_batch(
+    void *context,
+    const LevelDuration *pairs,
+    const ProtoPiratePulse *pulses,
+    size_t count)
+{
+    furi_assert(context);
+    SubGhzProtocolDecoderKIA *instance = context;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        subghz_protocol_decoder_kia_step(
+            instance,
+            level_duration_get_level(pairs[i]),
+            level_duration_get_duration(pairs[i]),
+            pulses[i]);
+    }
+}
+
+void subghz_protocol_decoder_kia_feed(void *context, bool level, uint32_t duration)
+{
+    subghz_protocol_decoder_kia_feed_pulse(
+        context, level, duration, protopirate_pulse_classify(&subghz_protocol_kia_const, duration));
+}
+
 static void subghz_protocol_kia_check_remote_controller(SubGhzBlockGeneric *instance)
 {
     instance->serial = (uint32_t)((instance->data >> 12) & 0x0FFFFFFF);
@@ -1,4 +1,5 @@
 #include "kia_v1.h"
+#include "protocol_manchester.h"
 
 #define TAG "KiaV1"
 
@@ -64,6 +65,16 @@ const SubGhzProtocol kia_protocol_v1 = {
     .encoder = &kia_protocol_v1_encoder,
 };
 
+const ProtoPirateDecoderExt kia_protocol_v1_decoder_ext = {
+    .protocol = &kia_protocol_v1,
+    .decoder_size = sizeof(SubGhzProtocolDecoderKiaV1),
+    .generic_offset = offsetof(SubGhzProtocolDecoderKiaV1, generic),
+    .timing = &kia_protocol_v1_const,
+    .feed_pulse = kia_protocol_decoder_v1_feed_pulse,
+    .preamble = ProtoPiratePreambleLongHigh,
+    .is_idle = kia_protocol_decoder_v1_is_idle,
+};
+
 static void kia_v1_add_raw_bit(SubGhzProtocolDecoderKiaV1 *instance, bool bit)
 {
     if (instance->raw_bit_count < 192)
@@ -82,13 +93,6 @@ static void kia_v1_add_raw_bit(SubGhzProtocolDecoderKiaV1 *instance, bool bit)
     }
 }
 
-static inline bool kia_v1_get_raw_bit(SubGhzProtocolDecoderKiaV1 *instance, uint16_t idx)
-{
-    uint16_t byte_idx = idx / 8;
-    uint8_t bit_idx = 7 - (idx % 8);
-    return (instance->raw_bits[byte_idx] >> bit_idx) & 1;
-}
-
 static bool kia_v1_manchester_decode(SubGhzProtocolDecoderKiaV1 *instance)
 {
     if (instance->raw_bit_count < 113)
@@ -108,46 +112,15 @@ static bool kia_v1_manchester_decode(SubGhzProtocolDecoderKiaV1 *instance)
         instance->raw_bits[5]);
 
     // Try different offsets to find best alignment (RTL-433 uses -1 bit offset)
-    uint16_t best_bits = 0;
     uint64_t best_data = 0;
     uint16_t best_offset = 0;
-
-    for (uint16_t offset = 0; offset < 8; offset++)
-    {
-        uint64_t data = 0;
-        uint16_t decoded_bits = 0;
-
-        for (uint16_t i = offset; i + 1 < instance->raw_bit_count && decoded_bits < 56; i += 2)
-        {
-            bool bit1 = kia_v1_get_raw_bit(instance, i);
-            bool bit2 = kia_v1_get_raw_bit(instance, i + 1);
-
-            uint8_t two_bits = (bit1 << 1) | bit2;
-
-            // V1 uses: 10=1, 01=0
-            if (two_bits == 0x02)
-            { // 10 = decoded 1
-                data = (data << 1) | 1;
-                decoded_bits++;
-            }
-            else if (two_bits == 0x01)
-            { // 01 = decoded 0
-                data = (data << 1);
-                decoded_bits++;
-            }
-            else
-            {
-                break;
-            }
-        }
-
-        if (decoded_bits > best_bits)
-        {
-            best_bits = decoded_bits;
-            best_data = data;
-            best_offset = offset;
-        }
-    }
+    uint16_t best_bits = protopirate_manchester_decode_best(
+        instance->raw_bits,
+        instance->raw_bit_count,
+        56,
+        ProtoPirateManchesterOneIsHighLow, // V1 uses: 10=1, 01=0
+        &best_data,
+        &best_offset);
 
     FURI_LOG_I(TAG, "Best: offset=%u bits=%u data=%014llX", best_offset, best_bits, best_data);
 
@@ -183,7 +156,18 @@ void kia_protocol_decoder_v1_reset(void *context)
     memset(instance->raw_bits, 0, sizeof(instance->raw_bits));
 }
 
-void kia_protocol_decoder_v1_feed(void *context, bool level, uint32_t duration)
+bool kia_protocol_decoder_v1_is_idle(void *context)
+{
+    furi_assert(context);
+    SubGhzProtocolDecoderKiaV1 *instance = context;
+    return instance->decoder.parser_step == KiaV1DecoderStepReset;
+}
+
+void kia_protocol_decoder_v1_feed_pulse(
+    void *context,
+    bool level,
+    uint32_t duration,
+    ProtoPiratePulse pulse)
 {
     furi_assert(context);
     SubGhzProtocolDecoderKiaV1 *instance = context;
@@ -192,8 +176,7 @@ void kia_protocol_decoder_v1_feed(void *context, bool level, uint32_t duration)
     {
     case KiaV1DecoderStepReset:
         // Preamble 0xCCCCCCCD produces alternating LONG pulses
-        if ((level) && (DURATION_DIFF(duration, kia_protocol_v1_const.te_long) <
-                        kia_protocol_v1_const.te_delta))
+        if ((level) && (pulse == ProtoPiratePulseLong))
         {
             instance->decoder.parser_step = KiaV1DecoderStepCheckPreamble;
             instance->decoder.te_last = duration;
@@ -204,15 +187,13 @@ void kia_protocol_decoder_v1_feed(void *context, bool level, uint32_t duration)
     case KiaV1DecoderStepCheckPreamble:
         if (level)
         {
-            if (DURATION_DIFF(duration, kia_protocol_v1_const.te_long) <
-                kia_protocol_v1_const.te_delta)
+            if (pulse == ProtoPiratePulseLong)
             {
                 instance->decoder.te_last = duration;
                 instance->header_count++;
             }
             else if (
-                DURATION_DIFF(duration, kia_protocol_v1_const.te_short) <
-                kia_protocol_v1_const.te_delta)
+                pulse == ProtoPiratePulseShort)
             {
                 instance->decoder.te_last = duration;
             }
@@ -224,14 +205,12 @@ void kia_protocol_decoder_v1_feed(void *context, bool level, uint32_t duration)
         else
         {
             // LOW pulse
-            if (DURATION_DIFF(duration, kia_protocol_v1_const.te_long) <
-                kia_protocol_v1_const.te_delta)
+            if (pulse == ProtoPiratePulseLong)
             {
                 instance->header_count++;
             }
             else if (
-                DURATION_DIFF(duration, kia_protocol_v1_const.te_short) <
-                kia_protocol_v1_const.te_delta)
+                pulse == ProtoPiratePulseShort)
             {
                 // Short LOW - this is the start of sync (0xCD ends: ...long H, short L, short H)
                 if (instance->header_count > 12)
@@ -248,8 +227,7 @@ void kia_protocol_decoder_v1_feed(void *context, bool level, uint32_t duration)
 
     case KiaV1DecoderStepFoundShortLow:
         // Expecting SHORT HIGH to complete sync
-        if (level && (DURATION_DIFF(duration, kia_protocol_v1_const.te_short) <
-                      kia_protocol_v1_const.te_delta))
+        if (level && (pulse == ProtoPiratePulseShort))
         {
             FURI_LOG_I(TAG, "Sync! hdr=%u", instance->header_count);
             instance->decoder.parser_step = KiaV1DecoderStepCollectRawBits;
@@ -300,14 +278,12 @@ void kia_protocol_decoder_v1_feed(void *context, bool level, uint32_t duration)
         }
 
         int num_bits = 0;
-        if (DURATION_DIFF(duration, kia_protocol_v1_const.te_short) <
-            kia_protocol_v1_const.te_delta)
+        if (pulse == ProtoPiratePulseShort)
         {
             num_bits = 1;
         }
         else if (
-            DURATION_DIFF(duration, kia_protocol_v1_const.te_long) <
-            kia_protocol_v1_const.te_delta)
+            pulse == ProtoPiratePulseLong)
         {
             num_bits = 2;
         }
@@ -332,6 +308,12 @@ void kia_protocol_decoder_v1_feed(void *context, bool level, uint32_t duration)
     }
 }
 
+void kia_protocol_decoder_v1_feed(void *context, bool level, uint32_t duration)
+{
+    kia_protocol_decoder_v1_feed_pulse(
+        context, level, duration, protopirate_pulse_classify(&kia_protocol_v1_const, duration));
+}
+
 uint8_t kia_protocol_decoder_v1_get_hash_data(void *context)
 {
     furi_assert(context);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "kia_generic.h"
+#include "protocol_pulse.h"
 
 #define KIA_PROTOCOL_V1_NAME "Kia V1"
 
@@ -10,11 +11,18 @@ typedef struct SubGhzProtocolEncoderKiaV1 SubGhzProtocolEncoderKiaV1;
 extern const SubGhzProtocolDecoder kia_protocol_v1_decoder;
 extern const SubGhzProtocolEncoder kia_protocol_v1_encoder;
 extern const SubGhzProtocol kia_protocol_v1;
+extern const ProtoPirateDecoderExt kia_protocol_v1_decoder_ext;
 
 void* kia_protocol_decoder_v1_alloc(SubGhzEnvironment* environment);
 void kia_protocol_decoder_v1_free(void* context);
 void kia_protocol_decoder_v1_reset(void* context);
+bool kia_protocol_decoder_v1_is_idle(void* context);
 void kia_protocol_decoder_v1_feed(void* context, bool level, uint32_t duration);
+void kia_protocol_decoder_v1_feed_pulse(
+    void* context,
+    bool level,
+    uint32_t duration,
+    ProtoPiratePulse pulse);
 uint8_t kia_protocol_decoder_v1_get_hash_data(void* context);
 SubGhzProtocolStatus kia_protocol_decoder_v1_serialize(
     void* context,
@@ -1,4 +1,5 @@
 #include "kia_v2.h"
+#include "protocol_manchester.h"
 
 #define TAG "KiaV2"
 
@@ -62,6 +63,16 @@ const SubGhzProtocol kia_protocol_v2 = {
     .encoder = &kia_protocol_v2_encoder,
 };
 
+const ProtoPirateDecoderExt kia_protocol_v2_decoder_ext = {
+    .protocol = &kia_protocol_v2,
+    .decoder_size = sizeof(SubGhzProtocolDecoderKiaV2),
+    .generic_offset = offsetof(SubGhzProtocolDecoderKiaV2, generic),
+    .timing = &kia_protocol_v2_const,
+    .feed_pulse = kia_protocol_decoder_v2_feed_pulse,
+    .preamble = ProtoPiratePreambleLongHigh,
+    .is_idle = kia_protocol_decoder_v2_is_idle,
+};
+
 static void kia_v2_add_raw_bit(SubGhzProtocolDecoderKiaV2 *instance, bool bit)
 {
     if (instance->raw_bit_count < 160)
@@ -80,13 +91,6 @@ static void kia_v2_add_raw_bit(SubGhzProtocolDecoderKiaV2 *instance, bool bit)
     }
 }
 
-static inline bool kia_v2_get_raw_bit(SubGhzProtocolDecoderKiaV2 *instance, uint16_t idx)
-{
-    uint16_t byte_idx = idx / 8;
-    uint8_t bit_idx = 7 - (idx % 8);
-    return (instance->raw_bits[byte_idx] >> bit_idx) & 1;
-}
-
 static bool kia_v2_manchester_decode(SubGhzProtocolDecoderKiaV2 *instance)
 {
     if (instance->raw_bit_count < 100)
@@ -94,43 +98,18 @@ static bool kia_v2_manchester_decode(SubGhzProtocolDecoderKiaV2 *instance)
         return false;
     }
 
-    uint16_t best_bits = 0;
+    // Phase search is a single pass over the raw buffer, then one decode
     uint64_t best_data = 0;
+    uint16_t best_offset = 0;
+    uint16_t best_bits = protopirate_manchester_decode_best(
+        instance->raw_bits,
+        instance->raw_bit_count,
+        53,
+        ProtoPirateManchesterOneIsHighLow,
+        &best_data,
+        &best_offset);
 
-    for (uint16_t offset = 0; offset < 8; offset++)
-    {
-        uint64_t data = 0;
-        uint16_t decoded_bits = 0;
-
-        for (uint16_t i = offset; i + 1 < instance->raw_bit_count && decoded_bits < 53; i += 2)
-        {
-            bool bit1 = kia_v2_get_raw_bit(instance, i);
-            bool bit2 = kia_v2_get_raw_bit(instance, i + 1);
-
-            uint8_t two_bits = (bit1 << 1) | bit2;
-
-            if (two_bits == 0x02)
-            {
-                data = (data << 1) | 1;
-                decoded_bits++;
-            }
-            else if (two_bits == 0x01)
-            {
-                data = (data << 1);
-                decoded_bits++;
-            }
-            else
-            {
-                break;
-            }
-        }
-
-        if (decoded_bits > best_bits)
-        {
-            best_bits = decoded_bits;
-            best_data = data;
-        }
-    }
+    FURI_LOG_D(TAG, "Phase: offset=%u bits=%u", best_offset, best_bits);
 
     instance->decoder.decode_data = best_data;
     instance->decoder.decode_count_bit = best_bits;
@@ -164,7 +143,18 @@ void kia_protocol_decoder_v2_reset(void *context)
     memset(instance->raw_bits, 0, sizeof(instance->raw_bits));
 }
 
-void kia_protocol_decoder_v2_feed(void *context, bool level, uint32_t duration)
+bool kia_protocol_decoder_v2_is_idle(void *context)
+{
+    furi_assert(context);
+    SubGhzProtocolDecoderKiaV2 *instance = context;
+    return instance->decoder.parser_step == KiaV2DecoderStepReset;
+}
+
+void kia_protocol_decoder_v2_feed_pulse(
+    void *context,
+    bool level,
+    uint32_t duration,
+    ProtoPiratePulse pulse)
 {
     furi_assert(context);
     SubGhzProtocolDecoderKiaV2 *instance = context;
@@ -172,8 +162,7 @@ void kia_protocol_decoder_v2_feed(void *context, bool level, uint32_t duration)
     switch (instance->decoder.parser_step)
     {
     case KiaV2DecoderStepReset:
-        if ((level) && (DURATION_DIFF(duration, kia_protocol_v2_const.te_long) <
-                        kia_protocol_v2_const.te_delta))
+        if ((level) && (pulse == ProtoPiratePulseLong))
         {
             instance->decoder.parser_step = KiaV2DecoderStepCheckPreamble;
             instance->decoder.te_last = duration;
@@ -184,15 +173,13 @@ void kia_protocol_decoder_v2_feed(void *context, bool level, uint32_t duration)
     case KiaV2DecoderStepCheckPreamble:
         if (level)
         {
-            if (DURATION_DIFF(duration, kia_protocol_v2_const.te_long) <
-                kia_protocol_v2_const.te_delta)
+            if (pulse == ProtoPiratePulseLong)
             {
                 instance->decoder.te_last = duration;
                 instance->header_count++;
             }
             else if (
-                DURATION_DIFF(duration, kia_protocol_v2_const.te_short) <
-                kia_protocol_v2_const.te_delta)
+                pulse == ProtoPiratePulseShort)
             {
                 instance->decoder.te_last = duration;
             }
@@ -203,14 +190,12 @@ void kia_protocol_decoder_v2_feed(void *context, bool level, uint32_t duration)
         }
         else
         {
-            if (DURATION_DIFF(duration, kia_protocol_v2_const.te_long) <
-                kia_protocol_v2_const.te_delta)
+            if (pulse == ProtoPiratePulseLong)
             {
                 instance->header_count++;
             }
             else if (
-                DURATION_DIFF(duration, kia_protocol_v2_const.te_short) <
-                kia_protocol_v2_const.te_delta)
+                pulse == ProtoPiratePulseShort)
             {
                 if (instance->header_count > 10 &&
                     DURATION_DIFF(instance->decoder.te_last, kia_protocol_v2_const.te_short) <
@@ -251,14 +236,12 @@ void kia_protocol_decoder_v2_feed(void *context, bool level, uint32_t duration)
         }
 
         int num_bits = 0;
-        if (DURATION_DIFF(duration, kia_protocol_v2_const.te_short) <
-            kia_protocol_v2_const.te_delta)
+        if (pulse == ProtoPiratePulseShort)
         {
             num_bits = 1;
         }
         else if (
-            DURATION_DIFF(duration, kia_protocol_v2_const.te_long) <
-            kia_protocol_v2_const.te_delta)
+            pulse == ProtoPiratePulseLong)
         {
             num_bits = 2;
         }
@@ -277,6 +260,12 @@ void kia_protocol_decoder_v2_feed(void *context, bool level, uint32_t duration)
     }
 }
 
+void kia_protocol_decoder_v2_feed(void *context, bool level, uint32_t duration)
+{
+    kia_protocol_decoder_v2_feed_pulse(
+        context, level, duration, protopirate_pulse_classify(&kia_protocol_v2_const, duration));
+}
+
 uint8_t kia_protocol_decoder_v2_get_hash_data(void *context)
 {
     furi_assert(context);
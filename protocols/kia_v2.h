@@ -1,6 +1,7 @@
 #pragma once
 
 #include "kia_generic.h"
+#include "protocol_pulse.h"
 
 #define KIA_PROTOCOL_V2_NAME "Kia V2"
 
@@ -10,11 +11,18 @@ typedef struct SubGhzProtocolEncoderKiaV2 SubGhzProtocolEncoderKiaV2;
 extern const SubGhzProtocolDecoder kia_protocol_v2_decoder;
 extern const SubGhzProtocolEncoder kia_protocol_v2_encoder;
 extern const SubGhzProtocol kia_protocol_v2;
+extern const ProtoPirateDecoderExt kia_protocol_v2_decoder_ext;
 
 void* kia_protocol_decoder_v2_alloc(SubGhzEnvironment* environment);
 void kia_protocol_decoder_v2_free(void* context);
 void kia_protocol_decoder_v2_reset(void* context);
+bool kia_protocol_decoder_v2_is_idle(void* context);
 void kia_protocol_decoder_v2_feed(void* context, bool level, uint32_t duration);
+void kia_protocol_decoder_v2_feed_pulse(
+    void* context,
+    bool level,
+    uint32_t duration,
+    ProtoPiratePulse pulse);
 uint8_t kia_protocol_decoder_v2_get_hash_data(void* context);
 SubGhzProtocolStatus kia_protocol_decoder_v2_serialize(
     void* context,
@@ -171,6 +171,21 @@ const SubGhzProtocol kia_protocol_v3_v4 = {
     .encoder = &kia_protocol_v3_v4_encoder,
 };
 
+const ProtoPirateDecoderExt kia_protocol_v3_v4_decoder_ext = {
+    .protocol = &kia_protocol_v3_v4,
+    .decoder_size = sizeof(SubGhzProtocolDecoderKiaV3V4),
+    .generic_offset = offsetof(SubGhzProtocolDecoderKiaV3V4, generic),
+    // encrypted, decrypted and version, no padding in between
+    .payload_offset = offsetof(SubGhzProtocolDecoderKiaV3V4, encrypted),
+    .payload_size = offsetof(SubGhzProtocolDecoderKiaV3V4, version) + sizeof(uint8_t) -
+                    offsetof(SubGhzProtocolDecoderKiaV3V4, encrypted),
+    .timing = &kia_protocol_v3_v4_const,
+    .feed_pulse = kia_protocol_decoder_v3_v4_feed_pulse,
+    .preamble = ProtoPiratePreambleShortHigh,
+    .is_idle = kia_protocol_decoder_v3_v4_is_idle,
+    .get_name = kia_protocol_decoder_v3_v4_get_name,
+};
+
 void *kia_protocol_decoder_v3_v4_alloc(SubGhzEnvironment *environment)
 {
     UNUSED(environment);
@@ -197,7 +212,25 @@ void kia_protocol_decoder_v3_v4_reset(void *context)
     memset(instance->raw_bits, 0, sizeof(instance->raw_bits));
 }
 
-void kia_protocol_decoder_v3_v4_feed(void *context, bool level, uint32_t duration)
+bool kia_protocol_decoder_v3_v4_is_idle(void *context)
+{
+    furi_assert(context);
+    SubGhzProtocolDecoderKiaV3V4 *instance = context;
+    return instance->decoder.parser_step == KiaV3V4DecoderStepReset;
+}
+
+const char *kia_protocol_decoder_v3_v4_get_name(void *context)
+{
+    furi_assert(context);
+    SubGhzProtocolDecoderKiaV3V4 *instance = context;
+    return kia_version_names[instance->version];
+}
+
+void kia_protocol_decoder_v3_v4_feed_pulse(
+    void *context,
+    bool level,
+    uint32_t duration,
+    ProtoPiratePulse pulse)
 {
     furi_assert(context);
     SubGhzProtocolDecoderKiaV3V4 *instance = context;
@@ -205,8 +238,7 @@ void kia_protocol_decoder_v3_v4_feed(void *context, bool level, uint32_t duratio
     switch (instance->decoder.parser_step)
     {
     case KiaV3V4DecoderStepReset:
-        if (level && DURATION_DIFF(duration, kia_protocol_v3_v4_const.te_short) <
-                         kia_protocol_v3_v4_const.te_delta)
+        if (level && pulse == ProtoPiratePulseShort)
         {
             instance->decoder.parser_step = KiaV3V4DecoderStepCheckPreamble;
             instance->decoder.te_last = duration;
@@ -217,8 +249,7 @@ void kia_protocol_decoder_v3_v4_feed(void *context, bool level, uint32_t duratio
     case KiaV3V4DecoderStepCheckPreamble:
         if (level)
         {
-            if (DURATION_DIFF(duration, kia_protocol_v3_v4_const.te_short) <
-                kia_protocol_v3_v4_const.te_delta)
+            if (pulse == ProtoPiratePulseShort)
             {
                 instance->decoder.te_last = duration;
             }
@@ -260,8 +291,7 @@ void kia_protocol_decoder_v3_v4_feed(void *context, bool level, uint32_t duratio
                 }
             }
             else if (
-                DURATION_DIFF(duration, kia_protocol_v3_v4_const.te_short) <
-                    kia_protocol_v3_v4_const.te_delta &&
+                pulse == ProtoPiratePulseShort &&
                 DURATION_DIFF(instance->decoder.te_last, kia_protocol_v3_v4_const.te_short) <
                     kia_protocol_v3_v4_const.te_delta)
             {
@@ -288,14 +318,12 @@ void kia_protocol_decoder_v3_v4_feed(void *context, bool level, uint32_t duratio
                 instance->decoder.parser_step = KiaV3V4DecoderStepReset;
             }
             else if (
-                DURATION_DIFF(duration, kia_protocol_v3_v4_const.te_short) <
-                kia_protocol_v3_v4_const.te_delta)
+                pulse == ProtoPiratePulseShort)
             {
                 kia_v3_v4_add_raw_bit(instance, false);
             }
             else if (
-                DURATION_DIFF(duration, kia_protocol_v3_v4_const.te_long) <
-                kia_protocol_v3_v4_const.te_delta)
+                pulse == ProtoPiratePulseLong)
             {
                 kia_v3_v4_add_raw_bit(instance, true);
             }
@@ -331,6 +359,12 @@ void kia_protocol_decoder_v3_v4_feed(void *context, bool level, uint32_t duratio
     }
 }
 
+void kia_protocol_decoder_v3_v4_feed(void *context, bool level, uint32_t duration)
+{
+    kia_protocol_decoder_v3_v4_feed_pulse(
+        context, level, duration, protopirate_pulse_classify(&kia_protocol_v3_v4_const, duration));
+}
+
 uint8_t kia_protocol_decoder_v3_v4_get_hash_data(void *context)
 {
     furi_assert(context);
@@ -1,15 +1,24 @@
 #pragma once
 
 #include "kia_generic.h"
+#include "protocol_pulse.h"
 
 #define KIA_PROTOCOL_V3_V4_NAME "Kia V3/V4"
 
 extern const SubGhzProtocol kia_protocol_v3_v4;
+extern const ProtoPirateDecoderExt kia_protocol_v3_v4_decoder_ext;
 
 void* kia_protocol_decoder_v3_v4_alloc(SubGhzEnvironment* environment);
 void kia_protocol_decoder_v3_v4_free(void* context);
 void kia_protocol_decoder_v3_v4_reset(void* context);
+bool kia_protocol_decoder_v3_v4_is_idle(void* context);
+const char* kia_protocol_decoder_v3_v4_get_name(void* context);
 void kia_protocol_decoder_v3_v4_feed(void* context, bool level, uint32_t duration);
+void kia_protocol_decoder_v3_v4_feed_pulse(
+    void* context,
+    bool level,
+    uint32_t duration,
+    ProtoPiratePulse pulse);
 uint8_t kia_protocol_decoder_v3_v4_get_hash_data(void* context);
 SubGhzProtocolStatus kia_protocol_decoder_v3_v4_serialize(
     void* context,
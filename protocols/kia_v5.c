@@ -1,4 +1,5 @@
 #include "kia_v5.h"
+#include "protocol_manchester.h"
 
 #define TAG "KiaV5"
 
@@ -61,6 +62,16 @@ const SubGhzProtocol kia_protocol_v5 = {
     .encoder = &kia_protocol_v5_encoder,
 };
 
+const ProtoPirateDecoderExt kia_protocol_v5_decoder_ext = {
+    .protocol = &kia_protocol_v5,
+    .decoder_size = sizeof(SubGhzProtocolDecoderKiaV5),
+    .generic_offset = offsetof(SubGhzProtocolDecoderKiaV5, generic),
+    .timing = &kia_protocol_v5_const,
+    .feed_pulse = kia_protocol_decoder_v5_feed_pulse,
+    .preamble = ProtoPiratePreambleShortHigh,
+    .is_idle = kia_protocol_decoder_v5_is_idle,
+};
+
 static void kia_v5_add_raw_bit(SubGhzProtocolDecoderKiaV5 *instance, bool bit)
 {
     if (instance->raw_bit_count < 256)
@@ -79,13 +90,6 @@ static void kia_v5_add_raw_bit(SubGhzProtocolDecoderKiaV5 *instance, bool bit)
     }
 }
 
-static inline bool kia_v5_get_raw_bit(SubGhzProtocolDecoderKiaV5 *instance, uint16_t idx)
-{
-    uint16_t byte_idx = idx / 8;
-    uint8_t bit_idx = 7 - (idx % 8);
-    return (instance->raw_bits[byte_idx] >> bit_idx) & 1;
-}
-
 static bool kia_v5_manchester_decode(SubGhzProtocolDecoderKiaV5 *instance)
 {
     if (instance->raw_bit_count < 130)
@@ -93,36 +97,17 @@ static bool kia_v5_manchester_decode(SubGhzProtocolDecoderKiaV5 *instance)
         return false;
     }
 
-    instance->decoder.decode_data = 0;
-    instance->decoder.decode_count_bit = 0;
-
     // Start at offset 2 for proper Manchester alignment
     const uint16_t start_bit = 2;
 
-    for (uint16_t i = start_bit;
-         i + 1 < instance->raw_bit_count && instance->decoder.decode_count_bit < 64;
-         i += 2)
-    {
-        bool bit1 = kia_v5_get_raw_bit(instance, i);
-        bool bit2 = kia_v5_get_raw_bit(instance, i + 1);
-
-        uint8_t two_bits = (bit1 << 1) | bit2;
-
-        if (two_bits == 0x01)
-        { // 01 = decoded 1
-            instance->decoder.decode_data = (instance->decoder.decode_data << 1) | 1;
-            instance->decoder.decode_count_bit++;
-        }
-        else if (two_bits == 0x02)
-        { // 10 = decoded 0
-            instance->decoder.decode_data = (instance->decoder.decode_data << 1);
-            instance->decoder.decode_count_bit++;
-        }
-        else
-        {
-            break;
-        }
-    }
+    instance->decoder.decode_count_bit = protopirate_manchester_decode(
+        instance->raw_bits,
+        instance->raw_bit_count,
+        start_bit,
+        64,
+        ProtoPirateManchesterOneIsLowHigh, // 01 = decoded 1, 10 = decoded 0
+        &instance->decoder.decode_data,
+        NULL);
 
     return instance->decoder.decode_count_bit >= kia_protocol_v5_const.min_count_bit_for_found;
 }
@@ -153,7 +138,18 @@ void kia_protocol_decoder_v5_reset(void *context)
     memset(instance->raw_bits, 0, sizeof(instance->raw_bits));
 }
 
-void kia_protocol_decoder_v5_feed(void *context, bool level, uint32_t duration)
+bool kia_protocol_decoder_v5_is_idle(void *context)
+{
+    furi_assert(context);
+    SubGhzProtocolDecoderKiaV5 *instance = context;
+    return instance->decoder.parser_step == KiaV5DecoderStepReset;
+}
+
+void kia_protocol_decoder_v5_feed_pulse(
+    void *context,
+    bool level,
+    uint32_t duration,
+    ProtoPiratePulse pulse)
 {
     furi_assert(context);
     SubGhzProtocolDecoderKiaV5 *instance = context;
@@ -161,8 +157,7 @@ void kia_protocol_decoder_v5_feed(void *context, bool level, uint32_t duration)
     switch (instance->decoder.parser_step)
     {
     case KiaV5DecoderStepReset:
-        if ((level) && (DURATION_DIFF(duration, kia_protocol_v5_const.te_short) <
-                        kia_protocol_v5_const.te_delta))
+        if ((level) && (pulse == ProtoPiratePulseShort))
         {
             instance->decoder.parser_step = KiaV5DecoderStepCheckPreamble;
             instance->decoder.te_last = duration;
@@ -173,10 +168,8 @@ void kia_protocol_decoder_v5_feed(void *context, bool level, uint32_t duration)
     case KiaV5DecoderStepCheckPreamble:
         if (level)
         {
-            if ((DURATION_DIFF(duration, kia_protocol_v5_const.te_short) <
-                 kia_protocol_v5_const.te_delta) ||
-                (DURATION_DIFF(duration, kia_protocol_v5_const.te_long) <
-                 kia_protocol_v5_const.te_delta))
+            if ((pulse == ProtoPiratePulseShort) ||
+                (pulse == ProtoPiratePulseLong))
             {
                 instance->decoder.te_last = duration;
             }
@@ -187,16 +180,14 @@ void kia_protocol_decoder_v5_feed(void *context, bool level, uint32_t duration)
         }
         else
         {
-            if ((DURATION_DIFF(duration, kia_protocol_v5_const.te_short) <
-                 kia_protocol_v5_const.te_delta) &&
+            if ((pulse == ProtoPiratePulseShort) &&
                 (DURATION_DIFF(instance->decoder.te_last, kia_protocol_v5_const.te_short) <
                  kia_protocol_v5_const.te_delta))
             {
                 instance->header_count++;
             }
             else if (
-                (DURATION_DIFF(duration, kia_protocol_v5_const.te_long) <
-                 kia_protocol_v5_const.te_delta) &&
+                (pulse == ProtoPiratePulseLong) &&
                 (DURATION_DIFF(instance->decoder.te_last, kia_protocol_v5_const.te_short) <
                  kia_protocol_v5_const.te_delta))
             {
@@ -268,14 +259,12 @@ void kia_protocol_decoder_v5_feed(void *context, bool level, uint32_t duration)
         }
 
         int num_bits = 0;
-        if (DURATION_DIFF(duration, kia_protocol_v5_const.te_short) <
-            kia_protocol_v5_const.te_delta)
+        if (pulse == ProtoPiratePulseShort)
         {
             num_bits = 1;
         }
         else if (
-            DURATION_DIFF(duration, kia_protocol_v5_const.te_long) <
-            kia_protocol_v5_const.te_delta)
+            pulse == ProtoPiratePulseLong)
         {
             num_bits = 2;
         }
@@ -294,6 +283,12 @@ void kia_protocol_decoder_v5_feed(void *context, bool level, uint32_t duration)
     }
 }
 
+void kia_protocol_decoder_v5_feed(void *context, bool level, uint32_t duration)
+{
+    kia_protocol_decoder_v5_feed_pulse(
+        context, level, duration, protopirate_pulse_classify(&kia_protocol_v5_const, duration));
+}
+
 uint8_t kia_protocol_decoder_v5_get_hash_data(void *context)
 {
     furi_assert(context);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "kia_generic.h"
+#include "protocol_pulse.h"
 
 #define KIA_PROTOCOL_V5_NAME "Kia V5"
 
@@ -10,11 +11,18 @@ typedef struct SubGhzProtocolEncoderKiaV5 SubGhzProtocolEncoderKiaV5;
 extern const SubGhzProtocolDecoder kia_protocol_v5_decoder;
 extern const SubGhzProtocolEncoder kia_protocol_v5_encoder;
 extern const SubGhzProtocol kia_protocol_v5;
+extern const ProtoPirateDecoderExt kia_protocol_v5_decoder_ext;
 
 void* kia_protocol_decoder_v5_alloc(SubGhzEnvironment* environment);
 void kia_protocol_decoder_v5_free(void* context);
 void kia_protocol_decoder_v5_reset(void* context);
+bool kia_protocol_decoder_v5_is_idle(void* context);
 void kia_protocol_decoder_v5_feed(void* context, bool level, uint32_t duration);
+void kia_protocol_decoder_v5_feed_pulse(
+    void* context,
+    bool level,
+    uint32_t duration,
+    ProtoPiratePulse pulse);
 uint8_t kia_protocol_decoder_v5_get_hash_data(void* context);
 SubGhzProtocolStatus kia_protocol_decoder_v5_serialize(
     void* context,
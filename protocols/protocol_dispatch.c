@@ -0,0 +1,294 @@
+#include "protocol_dispatch.h"
+#include "protocol_items.h"
+
+#define TAG "ProtoPirateDispatch"
+
+#define PROTOPIRATE_DISPATCH_FAMILY_MAX 16
+#define PROTOPIRATE_DISPATCH_BATCH_MAX 32
+
+#define PROTOPIRATE_DISPATCH_BAND_MASK \
+    (SubGhzProtocolFlag_315 | SubGhzProtocolFlag_433 | SubGhzProtocolFlag_868)
+#define PROTOPIRATE_DISPATCH_MODULATION_MASK (SubGhzProtocolFlag_AM | SubGhzProtocolFlag_FM)
+
+typedef struct
+{
+    SubGhzProtocolDecoderBase *decoder;
+    const ProtoPirateDecoderExt *ext;
+    uint8_t family;
+    // Decoder is in its reset step and only wakes on its preamble pulse
+    bool parked;
+} ProtoPirateDispatchSlot;
+
+struct ProtoPirateDispatch
+{
+    SubGhzReceiver *receiver;
+    SubGhzProtocolFlag filter;
+
+    ProtoPirateDispatchSlot *slots;
+    size_t slot_count;
+
+    const SubGhzBlockConst *families[PROTOPIRATE_DISPATCH_FAMILY_MAX];
+    uint8_t family_count;
+
+    // Pending burst, classified per timing family as pairs arrive
+    LevelDuration pairs[PROTOPIRATE_DISPATCH_BATCH_MAX];
+    ProtoPiratePulse pulses[PROTOPIRATE_DISPATCH_FAMILY_MAX][PROTOPIRATE_DISPATCH_BATCH_MAX];
+    size_t batch_count;
+
+    // Set by protopirate_dispatch_retune, consumed in the worker thread
+    bool retuned;
+};
+
+static uint8_t protopirate_dispatch_get_family(
+    ProtoPirateDispatch *instance,
+    const SubGhzBlockConst *timing)
+{
+    for (uint8_t i = 0; i < instance->family_count; i++)
+    {
+        const SubGhzBlockConst *family = instance->families[i];
+        if (family->te_short == timing->te_short && family->te_long == timing->te_long &&
+            family->te_delta == timing->te_delta)
+        {
+            return i;
+        }
+    }
+
+    furi_check(instance->family_count < PROTOPIRATE_DISPATCH_FAMILY_MAX);
+    instance->families[instance->family_count] = timing;
+    return instance->family_count++;
+}
+
+static bool protopirate_dispatch_slot_is_parked(const ProtoPirateDispatchSlot *slot)
+{
+    switch (slot->ext->preamble)
+    {
+    case ProtoPiratePreambleAlways:
+        return false;
+    case ProtoPiratePreambleNever:
+        return true;
+    default:
+        return slot->ext->is_idle(slot->decoder);
+    }
+}
+
+ProtoPirateDispatch *protopirate_dispatch_alloc(SubGhzReceiver *receiver)
+{
+    furi_assert(receiver);
+    ProtoPirateDispatch *instance = malloc(sizeof(ProtoPirateDispatch));
+    instance->receiver = receiver;
+    instance->filter = SubGhzProtocolFlag_Decodable;
+    instance->family_count = 0;
+    instance->slot_count = 0;
+    instance->batch_count = 0;
+    instance->retuned = false;
+    instance->slots =
+        malloc(sizeof(ProtoPirateDispatchSlot) * protopirate_protocol_ext_registry.size);
+
+    for (size_t i = 0; i < protopirate_protocol_ext_registry.size; i++)
+    {
+        const ProtoPirateDecoderExt *ext = protopirate_protocol_ext_registry.items[i];
+        SubGhzProtocolDecoderBase *decoder =
+            subghz_receiver_search_decoder_base_by_name(receiver, ext->protocol->name);
+        if (!decoder)
+        {
+            FURI_LOG_W(TAG, "No decoder instance for %s", ext->protocol->name);
+            continue;
+        }
+
+        furi_check(
+            ext->is_idle || ext->preamble == ProtoPiratePreambleAlways ||
+            ext->preamble == ProtoPiratePreambleNever);
+
+        ProtoPirateDispatchSlot *slot = &instance->slots[instance->slot_count++];
+        slot->decoder = decoder;
+        slot->ext = ext;
+        slot->family = protopirate_dispatch_get_family(instance, ext->timing);
+        slot->parked = protopirate_dispatch_slot_is_parked(slot);
+    }
+
+    FURI_LOG_I(
+        TAG,
+        "%zu decoders in %u timing families",
+        instance->slot_count,
+        instance->family_count);
+
+    return instance;
+}
+
+void protopirate_dispatch_free(ProtoPirateDispatch *instance)
+{
+    furi_assert(instance);
+    free(instance->slots);
+    free(instance);
+}
+
+void protopirate_dispatch_set_filter(ProtoPirateDispatch *instance, SubGhzProtocolFlag filter)
+{
+    furi_assert(instance);
+    __atomic_store_n(&instance->filter, filter, __ATOMIC_RELAXED);
+    subghz_receiver_set_filter(instance->receiver, filter);
+}
+
+// Other flags match like subghz_receiver_set_filter, on any shared bit. Band
+// and modulation narrow that down when the filter names them, a decoder
+// that declares neither is never excluded by them.
+static bool protopirate_dispatch_match(SubGhzProtocolFlag flag, SubGhzProtocolFlag filter)
+{
+    const uint32_t groups[] = {
+        PROTOPIRATE_DISPATCH_BAND_MASK,
+        PROTOPIRATE_DISPATCH_MODULATION_MASK,
+    };
+
+    const uint32_t shared = flag & filter;
+    if (!(shared & ~(PROTOPIRATE_DISPATCH_BAND_MASK | PROTOPIRATE_DISPATCH_MODULATION_MASK)))
+    {
+        return false;
+    }
+    for (size_t i = 0; i < COUNT_OF(groups); i++)
+    {
+        if ((filter & groups[i]) && (flag & groups[i]) && !(shared & groups[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Default adapter for decoders without feed_batch
+static void protopirate_dispatch_feed_slot(
+    ProtoPirateDispatchSlot *slot,
+    const LevelDuration *pairs,
+    const ProtoPiratePulse *pulses,
+    size_t count)
+{
+    const ProtoPirateDecoderExt *ext = slot->ext;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        bool level = level_duration_get_level(pairs[i]);
+        if (slot->parked && !protopirate_preamble_match(ext->preamble, level, pulses[i]))
+        {
+            continue;
+        }
+
+        uint32_t duration = level_duration_get_duration(pairs[i]);
+        if (ext->feed_pulse)
+        {
+            ext->feed_pulse(slot->decoder, level, duration, pulses[i]);
+        }
+        else
+        {
+            ext->protocol->decoder->feed(slot->decoder, level, duration);
+        }
+        slot->parked = protopirate_dispatch_slot_is_parked(slot);
+    }
+}
+
+static void protopirate_dispatch_flush(ProtoPirateDispatch *instance)
+{
+    const size_t count = instance->batch_count;
+    // Changed by hops from the timer thread
+    const SubGhzProtocolFlag filter = __atomic_load_n(&instance->filter, __ATOMIC_RELAXED);
+
+    for (size_t i = 0; i < instance->slot_count; i++)
+    {
+        ProtoPirateDispatchSlot *slot = &instance->slots[i];
+        const ProtoPirateDecoderExt *ext = slot->ext;
+        if (!protopirate_dispatch_match(ext->protocol->flag, filter))
+        {
+            continue;
+        }
+
+        const ProtoPiratePulse *pulses = instance->pulses[slot->family];
+        if (!ext->feed_batch)
+        {
+            protopirate_dispatch_feed_slot(slot, instance->pairs, pulses, count);
+            continue;
+        }
+
+        // A parked decoder ignores everything before its preamble pulse
+        size_t start = 0;
+        if (slot->parked)
+        {
+            while (start < count &&
+                   !protopirate_preamble_match(
+                       ext->preamble, level_duration_get_level(instance->pairs[start]),
+                       pulses[start]))
+            {
+                start++;
+            }
+        }
+        if (start < count)
+        {
+            ext->feed_batch(slot->decoder, &instance->pairs[start], &pulses[start], count - start);
+            slot->parked = protopirate_dispatch_slot_is_parked(slot);
+        }
+    }
+
+    instance->batch_count = 0;
+}
+
+// Pulses from before a retune belong to another frequency
+static void protopirate_dispatch_drop(ProtoPirateDispatch *instance)
+{
+    instance->batch_count = 0;
+
+    for (size_t i = 0; i < instance->slot_count; i++)
+    {
+        ProtoPirateDispatchSlot *slot = &instance->slots[i];
+        if (!slot->parked)
+        {
+            slot->ext->protocol->decoder->reset(slot->decoder);
+            slot->parked = protopirate_dispatch_slot_is_parked(slot);
+        }
+    }
+}
+
+void protopirate_dispatch_feed(void *context, bool level, uint32_t duration)
+{
+    ProtoPirateDispatch *instance = context;
+    if (__atomic_exchange_n(&instance->retuned, false, __ATOMIC_ACQUIRE))
+    {
+        protopirate_dispatch_drop(instance);
+    }
+
+    const size_t index = instance->batch_count++;
+    instance->pairs[index] = level_duration_make(level, duration);
+
+    // Classify once per timing family, not once per protocol
+    bool burst_end = true;
+    for (uint8_t i = 0; i < instance->family_count; i++)
+    {
+        ProtoPiratePulse pulse = protopirate_pulse_classify(instance->families[i], duration);
+        instance->pulses[i][index] = pulse;
+        if (pulse != ProtoPiratePulseOther)
+        {
+            burst_end = false;
+        }
+    }
+
+    // A pulse no family recognises (gap or noise) closes the burst
+    if (burst_end || instance->batch_count == PROTOPIRATE_DISPATCH_BATCH_MAX)
+    {
+        protopirate_dispatch_flush(instance);
+    }
+}
+
+void protopirate_dispatch_reset(void *context)
+{
+    ProtoPirateDispatch *instance = context;
+    instance->batch_count = 0;
+    __atomic_store_n(&instance->retuned, false, __ATOMIC_RELAXED);
+    subghz_receiver_reset(instance->receiver);
+
+    for (size_t i = 0; i < instance->slot_count; i++)
+    {
+        instance->slots[i].parked = protopirate_dispatch_slot_is_parked(&instance->slots[i]);
+    }
+}
+
+void protopirate_dispatch_retune(ProtoPirateDispatch *instance)
+{
+    furi_assert(instance);
+    __atomic_store_n(&instance->retuned, true, __ATOMIC_RELEASE);
+}
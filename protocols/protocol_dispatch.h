@@ -0,0 +1,20 @@
+#pragma once
+
+#include "protocol_pulse.h"
+#include <lib/subghz/receiver.h>
+
+typedef struct ProtoPirateDispatch ProtoPirateDispatch;
+
+ProtoPirateDispatch *protopirate_dispatch_alloc(SubGhzReceiver *receiver);
+void protopirate_dispatch_free(ProtoPirateDispatch *instance);
+// Band (_315/_433/_868) and modulation (_AM/_FM) flags in filter must also
+// match when the decoder declares them. Safe while the worker runs.
+void protopirate_dispatch_set_filter(ProtoPirateDispatch *instance, SubGhzProtocolFlag filter);
+
+// SubGhzWorkerPairCallback replacement for subghz_receiver_decode
+void protopirate_dispatch_feed(void *context, bool level, uint32_t duration);
+// SubGhzWorkerOverrunCallback replacement for subghz_receiver_reset
+void protopirate_dispatch_reset(void *context);
+// Safe while the worker runs: on the next pair fed, the pending burst and
+// every decoder caught mid-frame are dropped, parked decoders are left alone
+void protopirate_dispatch_retune(ProtoPirateDispatch *instance);
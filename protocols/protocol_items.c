@@ -30,3 +30,39 @@ const SubGhzProtocolRegistry protopirate_protocol_registry = {
     .items = protopirate_protocol_registry_items,
     .size = COUNT_OF(protopirate_protocol_registry_items),
 };
+
+// Decoder extensions, consumed by protocol_dispatch.c in place of
+// subghz_receiver_decode. Must cover every protocol in the registry above.
+const ProtoPirateDecoderExt* protopirate_protocol_ext_items[] = {
+    &kia_protocol_v0_decoder_ext,
+    &kia_protocol_v1_decoder_ext,
+    &kia_protocol_v2_decoder_ext,
+    &kia_protocol_v3_v4_decoder_ext,
+    &kia_protocol_v5_decoder_ext,
+    &hyundai_protocol_v0_decoder_ext,
+    &ford_protocol_v0_decoder_ext,
+    &subaru_protocol_decoder_ext,
+    &suzuki_protocol_decoder_ext,
+    &honda_protocol_v0_decoder_ext,
+    &honda_protocol_v2_decoder_ext,
+    &vw_protocol_decoder_ext,
+    &citroen_protocol_decoder_ext,
+    &fiat_protocol_v0_decoder_ext,
+};
+
+const ProtoPirateDecoderExtRegistry protopirate_protocol_ext_registry = {
+    .items = protopirate_protocol_ext_items,
+    .size = COUNT_OF(protopirate_protocol_ext_items),
+};
+
+const ProtoPirateDecoderExt* protopirate_protocol_ext_find(const SubGhzProtocol* protocol)
+{
+    for (size_t i = 0; i < protopirate_protocol_ext_registry.size; i++)
+    {
+        if (protopirate_protocol_ext_registry.items[i]->protocol == protocol)
+        {
+            return protopirate_protocol_ext_registry.items[i];
+        }
+    }
+    return NULL;
+}
@@ -32,3 +32,5 @@
 // Note: tesla.h is not implemented yet
 
 extern const SubGhzProtocolRegistry protopirate_protocol_registry;
+extern const ProtoPirateDecoderExtRegistry protopirate_protocol_ext_registry;
+const ProtoPirateDecoderExt* protopirate_protocol_ext_find(const SubGhzProtocol* protocol);
@@ -0,0 +1,186 @@
+#include "protocol_manchester.h"
+
+#define PROTOPIRATE_MANCHESTER_PAIRS_PER_STEP 4
+
+// Indexed by four raw pairs (one byte, MSB first) under the HighLow polarity.
+// High nibble: number of leading valid pairs. Low nibble: their decoded bits,
+// right-aligned. Low-high polarity is the same table with the bits inverted.
+static const uint8_t protopirate_manchester_table[256] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+    0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+    0x20, 0x20, 0x20, 0x20, 0x30, 0x40, 0x41, 0x30,
+    0x31, 0x42, 0x43, 0x31, 0x20, 0x20, 0x20, 0x20,
+    0x21, 0x21, 0x21, 0x21, 0x32, 0x44, 0x45, 0x32,
+    0x33, 0x46, 0x47, 0x33, 0x21, 0x21, 0x21, 0x21,
+    0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+    0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+    0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+    0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+    0x22, 0x22, 0x22, 0x22, 0x34, 0x48, 0x49, 0x34,
+    0x35, 0x4A, 0x4B, 0x35, 0x22, 0x22, 0x22, 0x22,
+    0x23, 0x23, 0x23, 0x23, 0x36, 0x4C, 0x4D, 0x36,
+    0x37, 0x4E, 0x4F, 0x37, 0x23, 0x23, 0x23, 0x23,
+    0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+    0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+// Next 8 raw bits starting at pos, left-aligned. Only touches the second
+// byte when the window actually crosses into it, so reads stay in the buffer.
+static inline uint8_t
+protopirate_manchester_window(const uint8_t *raw, uint16_t pos, uint16_t raw_bit_count)
+{
+    const uint16_t byte_idx = pos / 8;
+    const uint8_t shift = pos % 8;
+    uint8_t window = raw[byte_idx] << shift;
+    if (shift && (uint16_t)(pos + 8 - shift) < raw_bit_count)
+    {
+        window |= raw[byte_idx + 1] >> (8 - shift);
+    }
+    return window;
+}
+
+uint16_t protopirate_manchester_decode(
+    const uint8_t *raw,
+    uint16_t raw_bit_count,
+    uint16_t offset,
+    uint16_t max_bits,
+    ProtoPirateManchesterPolarity polarity,
+    uint64_t *data,
+    uint16_t *stop)
+{
+    furi_assert(raw);
+    furi_assert(data);
+
+    uint64_t result = 0;
+    uint16_t decoded = 0;
+    uint16_t pos = offset;
+
+    while (decoded < max_bits && pos + 1 < raw_bit_count)
+    {
+        uint8_t want = (raw_bit_count - pos) / 2;
+        if (want > PROTOPIRATE_MANCHESTER_PAIRS_PER_STEP)
+        {
+            want = PROTOPIRATE_MANCHESTER_PAIRS_PER_STEP;
+        }
+        if (want > max_bits - decoded)
+        {
+            want = max_bits - decoded;
+        }
+
+        const uint8_t entry =
+            protopirate_manchester_table[protopirate_manchester_window(raw, pos, raw_bit_count)];
+        uint8_t count = entry >> 4;
+        uint8_t bits = entry & 0x0F;
+        if (count > want)
+        {
+            bits >>= count - want;
+            count = want;
+        }
+        if (polarity == ProtoPirateManchesterOneIsLowHigh)
+        {
+            bits ^= (1 << count) - 1;
+        }
+
+        result = (result << count) | bits;
+        decoded += count;
+        pos += count * 2;
+
+        if (count < want)
+        {
+            break;
+        }
+    }
+
+    *data = result;
+    if (stop)
+    {
+        *stop = pos;
+    }
+    return decoded;
+}
+
+uint16_t protopirate_manchester_align(
+    const uint8_t *raw,
+    uint16_t raw_bit_count,
+    uint16_t max_bits,
+    uint16_t *offset)
+{
+    furi_assert(raw);
+    furi_assert(offset);
+
+    // A pair starting at raw bit i is valid when bits i and i + 1 differ,
+    // independent of polarity. Offset o consumes the pairs at i = o, o + 2, ...
+    // so each raw position extends at most four candidate runs.
+    uint16_t run[8] = {0};
+    uint8_t alive = max_bits ? 0xFF : 0x00;
+    bool bit = raw_bit_count ? (raw[0] >> 7) & 1 : false;
+
+    for (uint16_t i = 0; i + 1 < raw_bit_count && alive; i++)
+    {
+        const bool next = (raw[(i + 1) / 8] >> (7 - ((i + 1) % 8))) & 1;
+        const bool valid = bit != next;
+        bit = next;
+
+        for (uint16_t o = i & 1; o <= i && o < 8; o += 2)
+        {
+            if (!(alive & (1 << o)))
+            {
+                continue;
+            }
+            if (!valid || ++run[o] == max_bits)
+            {
+                alive &= ~(1 << o);
+            }
+        }
+    }
+
+    uint16_t best_bits = 0;
+    uint16_t best_offset = 0;
+    for (uint16_t o = 0; o < 8; o++)
+    {
+        if (run[o] > best_bits)
+        {
+            best_bits = run[o];
+            best_offset = o;
+        }
+    }
+
+    *offset = best_offset;
+    return best_bits;
+}
+
+uint16_t protopirate_manchester_decode_best(
+    const uint8_t *raw,
+    uint16_t raw_bit_count,
+    uint16_t max_bits,
+    ProtoPirateManchesterPolarity polarity,
+    uint64_t *data,
+    uint16_t *offset)
+{
+    uint16_t best_offset = 0;
+    protopirate_manchester_align(raw, raw_bit_count, max_bits, &best_offset);
+
+    uint16_t bits = protopirate_manchester_decode(
+        raw, raw_bit_count, best_offset, max_bits, polarity, data, NULL);
+    if (offset)
+    {
+        *offset = best_offset;
+    }
+    return bits;
+}
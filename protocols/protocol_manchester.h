@@ -0,0 +1,44 @@
+#pragma once
+
+#include <furi.h>
+
+// Which raw half-bit pair decodes to a 1. The opposite pair decodes to 0,
+// 00 and 11 are invalid and end the decode.
+typedef enum
+{
+    ProtoPirateManchesterOneIsHighLow, // 10 = 1, 01 = 0
+    ProtoPirateManchesterOneIsLowHigh, // 01 = 1, 10 = 0
+} ProtoPirateManchesterPolarity;
+
+// Decodes Manchester pairs from an MSB-first raw half-bit buffer, starting at
+// raw bit `offset`, four pairs per table lookup. Decoded bits are shifted into
+// *data MSB-first. Stops after max_bits, at the end of the buffer or at the
+// first invalid pair, whose raw bit index is stored in *stop if non-NULL.
+// Returns the number of decoded bits.
+uint16_t protopirate_manchester_decode(
+    const uint8_t *raw,
+    uint16_t raw_bit_count,
+    uint16_t offset,
+    uint16_t max_bits,
+    ProtoPirateManchesterPolarity polarity,
+    uint64_t *data,
+    uint16_t *stop);
+
+// Finds the raw offset 0-7 that yields the most decoded bits (up to max_bits)
+// in a single pass over the buffer, the lowest offset wins a tie. Stores the
+// winning offset in *offset and returns its bit count.
+uint16_t protopirate_manchester_align(
+    const uint8_t *raw,
+    uint16_t raw_bit_count,
+    uint16_t max_bits,
+    uint16_t *offset);
+
+// protopirate_manchester_align followed by a single decode at the winning
+// offset, which is stored in *offset if non-NULL.
+uint16_t protopirate_manchester_decode_best(
+    const uint8_t *raw,
+    uint16_t raw_bit_count,
+    uint16_t max_bits,
+    ProtoPirateManchesterPolarity polarity,
+    uint64_t *data,
+    uint16_t *offset);
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <furi.h>
+#include <lib/subghz/protocols/base.h>
+#include <lib/subghz/blocks/const.h>
+#include <lib/subghz/blocks/math.h>
+#include <lib/toolbox/level_duration.h>
+
+// Pulse class of a single (level, duration) pair within one timing family.
+// A timing family is a distinct te_short/te_long/te_delta triple, shared by
+// every protocol declaring the same SubGhzBlockConst values.
+typedef enum
+{
+    ProtoPiratePulseOther = 0,
+    ProtoPiratePulseShort,
+    ProtoPiratePulseLong,
+} ProtoPiratePulse;
+
+// Decoder entry point consuming a pulse already classified against the
+// protocol's own timing family. Duration is still passed for gap checks.
+typedef void (*ProtoPirateDecoderFeedPulse)(
+    void *context,
+    bool level,
+    uint32_t duration,
+    ProtoPiratePulse pulse);
+
+// First pulse accepted by a decoder's ...StepReset case. While the decoder
+// sits in reset, any other pulse is a no-op for it and can be skipped.
+typedef enum
+{
+    ProtoPiratePreambleAlways = 0, // No gating, fed every pulse
+    ProtoPiratePreambleShortHigh,
+    ProtoPiratePreambleLongHigh,
+    ProtoPiratePreambleShortAny,
+    ProtoPiratePreambleHigh, // Any HIGH pulse, the decoder checks its own window
+    ProtoPiratePreambleNever, // Placeholder decoder, never fed
+} ProtoPiratePreamble;
+
+typedef bool (*ProtoPirateDecoderIsIdle)(void *context);
+
+// Display name of a decoded frame, must point at static storage
+typedef const char *(*ProtoPirateDecoderGetName)(void *context);
+
+// Consumes a burst of pairs in one call, pulses[i] classifies pairs[i]
+typedef void (*ProtoPirateDecoderFeedBatch)(
+    void *context,
+    const LevelDuration *pairs,
+    const ProtoPiratePulse *pulses,
+    size_t count);
+
+// App-side extension of SubGhzProtocolDecoder, registered in protocol_items.c
+typedef struct
+{
+    const SubGhzProtocol *protocol;
+    // sizeof the decoder instance, for copying decoded frames off the worker
+    size_t decoder_size;
+    // offsetof its SubGhzBlockGeneric, to read key/serial/btn/cnt from a copy
+    size_t generic_offset;
+    // Payload bytes the decoder keeps outside generic, part of a frame's
+    // identity in history. 0 size when generic holds the whole frame.
+    size_t payload_offset;
+    size_t payload_size;
+    const SubGhzBlockConst *timing;
+    // NULL falls back to protocol->decoder->feed
+    ProtoPirateDecoderFeedPulse feed_pulse;
+    // NULL falls back to feeding the burst one pulse at a time
+    ProtoPirateDecoderFeedBatch feed_batch;
+    ProtoPiratePreamble preamble;
+    // True while the decoder is in its reset step, required for gating
+    ProtoPirateDecoderIsIdle is_idle;
+    // NULL falls back to protocol->name
+    ProtoPirateDecoderGetName get_name;
+} ProtoPirateDecoderExt;
+
+static inline ProtoPiratePulse
+protopirate_pulse_classify(const SubGhzBlockConst *timing, uint32_t duration)
+{
+    if (DURATION_DIFF(duration, timing->te_short) < timing->te_delta)
+    {
+        return ProtoPiratePulseShort;
+    }
+    if (DURATION_DIFF(duration, timing->te_long) < timing->te_delta)
+    {
+        return ProtoPiratePulseLong;
+    }
+    return ProtoPiratePulseOther;
+}
+
+static inline bool
+protopirate_preamble_match(ProtoPiratePreamble preamble, bool level, ProtoPiratePulse pulse)
+{
+    switch (preamble)
+    {
+    case ProtoPiratePreambleShortHigh:
+        return level && pulse == ProtoPiratePulseShort;
+    case ProtoPiratePreambleLongHigh:
+        return level && pulse == ProtoPiratePulseLong;
+    case ProtoPiratePreambleShortAny:
+        return pulse == ProtoPiratePulseShort;
+    case ProtoPiratePreambleHigh:
+        return level;
+    case ProtoPiratePreambleNever:
+        return false;
+    default:
+        return true;
+    }
+}
+
+typedef struct
+{
+    const ProtoPirateDecoderExt **items;
+    const size_t size;
+} ProtoPirateDecoderExtRegistry;
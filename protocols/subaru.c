@@ -69,6 +69,16 @@ const SubGhzProtocol subaru_protocol = {
     .encoder = &subghz_protocol_subaru_encoder,
 };
 
+const ProtoPirateDecoderExt subaru_protocol_decoder_ext = {
+    .protocol = &subaru_protocol,
+    .decoder_size = sizeof(SubGhzProtocolDecoderSubaru),
+    .generic_offset = offsetof(SubGhzProtocolDecoderSubaru, generic),
+    .timing = &subghz_protocol_subaru_const,
+    .feed_pulse = NULL,
+    .preamble = ProtoPiratePreambleLongHigh,
+    .is_idle = subghz_protocol_decoder_subaru_is_idle,
+};
+
 static void subaru_decode_count(const uint8_t *KB, uint16_t *count)
 {
     uint8_t lo = 0;
@@ -204,6 +214,13 @@ void subghz_protocol_decoder_subaru_reset(void *context)
     memset(instance->data, 0, sizeof(instance->data));
 }
 
+bool subghz_protocol_decoder_subaru_is_idle(void *context)
+{
+    furi_assert(context);
+    SubGhzProtocolDecoderSubaru *instance = context;
+    return instance->decoder.parser_step == SubaruDecoderStepReset;
+}
+
 void subghz_protocol_decoder_subaru_feed(void *context, bool level, uint32_t duration)
 {
     furi_assert(context);
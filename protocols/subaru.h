@@ -9,14 +9,17 @@
 #include <lib/subghz/blocks/generic.h>
 #include <lib/subghz/blocks/math.h>
 #include <flipper_format/flipper_format.h>
+#include "protocol_pulse.h"
 
 #define SUBARU_PROTOCOL_NAME "Subaru"
 
 extern const SubGhzProtocol subaru_protocol;
+extern const ProtoPirateDecoderExt subaru_protocol_decoder_ext;
 
 void* subghz_protocol_decoder_subaru_alloc(SubGhzEnvironment* environment);
 void subghz_protocol_decoder_subaru_free(void* context);
 void subghz_protocol_decoder_subaru_reset(void* context);
+bool subghz_protocol_decoder_subaru_is_idle(void* context);
 void subghz_protocol_decoder_subaru_feed(void* context, bool level, uint32_t duration);
 uint8_t subghz_protocol_decoder_subaru_get_hash_data(void* context);
 SubGhzProtocolStatus subghz_protocol_decoder_subaru_serialize(
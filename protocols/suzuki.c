@@ -66,6 +66,17 @@ const SubGhzProtocol suzuki_protocol = {
     .encoder = &subghz_protocol_suzuki_encoder,
 };
 
+const ProtoPirateDecoderExt suzuki_protocol_decoder_ext = {
+    .protocol = &suzuki_protocol,
+    .decoder_size = sizeof(SubGhzProtocolDecoderSuzuki),
+    .generic_offset = offsetof(SubGhzProtocolDecoderSuzuki, generic),
+    .timing = &subghz_protocol_suzuki_const,
+    .feed_pulse = subghz_protocol_decoder_suzuki_feed_pulse,
+    // Its start pulse window includes te_delta itself, wider than ProtoPiratePulseShort
+    .preamble = ProtoPiratePreambleHigh,
+    .is_idle = subghz_protocol_decoder_suzuki_is_idle,
+};
+
 static void suzuki_add_bit(SubGhzProtocolDecoderSuzuki *instance, uint32_t bit)
 {
     uint32_t carry = instance->data_low >> 31;
@@ -101,7 +112,18 @@ void subghz_protocol_decoder_suzuki_reset(void *context)
     instance->data_high = 0;
 }
 
-void subghz_protocol_decoder_suzuki_feed(void *context, bool level, uint32_t duration)
+bool subghz_protocol_decoder_suzuki_is_idle(void *context)
+{
+    furi_assert(context);
+    SubGhzProtocolDecoderSuzuki *instance = context;
+    return instance->decoder.parser_step == SuzukiDecoderStepReset;
+}
+
+void subghz_protocol_decoder_suzuki_feed_pulse(
+    void *context,
+    bool level,
+    uint32_t duration,
+    ProtoPiratePulse pulse)
 {
     furi_assert(context);
     SubGhzProtocolDecoderSuzuki *instance = context;
@@ -113,7 +135,8 @@ void subghz_protocol_decoder_suzuki_feed(void *context, bool level, uint32_t dur
         if (!level)
             return;
 
-        if (DURATION_DIFF(duration, subghz_protocol_suzuki_const.te_short) > subghz_protocol_suzuki_const.te_delta)
+        if (DURATION_DIFF(duration, subghz_protocol_suzuki_const.te_short) >
+            subghz_protocol_suzuki_const.te_delta)
         {
             return;
         }
@@ -136,7 +159,7 @@ void subghz_protocol_decoder_suzuki_feed(void *context, bool level, uint32_t dur
             }
 
             // After preamble, look for long HIGH to start data
-            if (DURATION_DIFF(duration, subghz_protocol_suzuki_const.te_long) < subghz_protocol_suzuki_const.te_delta)
+            if (pulse == ProtoPiratePulseLong)
             {
                 instance->decoder.parser_step = SuzukiDecoderStepSaveDuration;
                 suzuki_add_bit(instance, 1);
@@ -146,7 +169,7 @@ void subghz_protocol_decoder_suzuki_feed(void *context, bool level, uint32_t dur
         else
         {
             // LOW pulse - count as header if short
-            if (DURATION_DIFF(duration, subghz_protocol_suzuki_const.te_short) < subghz_protocol_suzuki_const.te_delta)
+            if (pulse == ProtoPiratePulseShort)
             {
                 instance->te_last = duration;
                 instance->header_count++;
@@ -163,11 +186,11 @@ void subghz_protocol_decoder_suzuki_feed(void *context, bool level, uint32_t dur
         {
             // HIGH pulse - determines bit value
             // Long HIGH (~500µs) = 1, Short HIGH (~250µs) = 0
-            if (DURATION_DIFF(duration, subghz_protocol_suzuki_const.te_long) < subghz_protocol_suzuki_const.te_delta)
+            if (pulse == ProtoPiratePulseLong)
             {
                 suzuki_add_bit(instance, 1);
             }
-            else if (DURATION_DIFF(duration, subghz_protocol_suzuki_const.te_short) < subghz_protocol_suzuki_const.te_delta)
+            else if (pulse == ProtoPiratePulseShort)
             {
                 suzuki_add_bit(instance, 0);
             }
@@ -213,6 +236,15 @@ void subghz_protocol_decoder_suzuki_feed(void *context, bool level, uint32_t dur
     }
 }
 
+void subghz_protocol_decoder_suzuki_feed(void *context, bool level, uint32_t duration)
+{
+    subghz_protocol_decoder_suzuki_feed_pulse(
+        context,
+        level,
+        duration,
+        protopirate_pulse_classify(&subghz_protocol_suzuki_const, duration));
+}
+
 uint8_t subghz_protocol_decoder_suzuki_get_hash_data(void *context)
 {
     furi_assert(context);
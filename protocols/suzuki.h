@@ -9,15 +9,23 @@
 #include <lib/subghz/blocks/generic.h>
 #include <lib/subghz/blocks/math.h>
 #include <flipper_format/flipper_format.h>
+#include "protocol_pulse.h"
 
 #define SUZUKI_PROTOCOL_NAME "Suzuki"
 
 extern const SubGhzProtocol suzuki_protocol;
+extern const ProtoPirateDecoderExt suzuki_protocol_decoder_ext;
 
 void* subghz_protocol_decoder_suzuki_alloc(SubGhzEnvironment* environment);
 void subghz_protocol_decoder_suzuki_free(void* context);
 void subghz_protocol_decoder_suzuki_reset(void* context);
+bool subghz_protocol_decoder_suzuki_is_idle(void* context);
 void subghz_protocol_decoder_suzuki_feed(void* context, bool level, uint32_t duration);
+void subghz_protocol_decoder_suzuki_feed_pulse(
+    void* context,
+    bool level,
+    uint32_t duration,
+    ProtoPiratePulse pulse);
 uint8_t subghz_protocol_decoder_suzuki_get_hash_data(void* context);
 SubGhzProtocolStatus subghz_protocol_decoder_suzuki_serialize(
     void* context,
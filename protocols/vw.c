@@ -63,6 +63,18 @@ const SubGhzProtocol vw_protocol = {
     .encoder = &subghz_protocol_vw_encoder,
 };
 
+const ProtoPirateDecoderExt vw_protocol_decoder_ext = {
+    .protocol = &vw_protocol,
+    .decoder_size = sizeof(SubGhzProtocolDecoderVw),
+    .generic_offset = offsetof(SubGhzProtocolDecoderVw, generic),
+    .payload_offset = offsetof(SubGhzProtocolDecoderVw, data_2),
+    .payload_size = sizeof(uint64_t),
+    .timing = &subghz_protocol_vw_const,
+    .feed_pulse = subghz_protocol_decoder_vw_feed_pulse,
+    .preamble = ProtoPiratePreambleShortAny,
+    .is_idle = subghz_protocol_decoder_vw_is_idle,
+};
+
 // Fixed manchester_advance for VW protocol
 static bool vw_manchester_advance(
     ManchesterState state,
@@ -240,7 +252,18 @@ void subghz_protocol_decoder_vw_reset(void *context)
     instance->manchester_state = ManchesterStateMid1;
 }
 
-void subghz_protocol_decoder_vw_feed(void *context, bool level, uint32_t duration)
+bool subghz_protocol_decoder_vw_is_idle(void *context)
+{
+    furi_assert(context);
+    SubGhzProtocolDecoderVw *instance = context;
+    return instance->decoder.parser_step == VwDecoderStepReset;
+}
+
+void subghz_protocol_decoder_vw_feed_pulse(
+    void *context,
+    bool level,
+    uint32_t duration,
+    ProtoPiratePulse pulse)
 {
     furi_assert(context);
     SubGhzProtocolDecoderVw *instance = context;
@@ -256,20 +279,20 @@ void subghz_protocol_decoder_vw_feed(void *context, bool level, uint32_t duratio
     switch (instance->decoder.parser_step)
     {
     case VwDecoderStepReset:
-        if (DURATION_DIFF(duration, te_short) < te_delta)
+        if (pulse == ProtoPiratePulseShort)
         {
             instance->decoder.parser_step = VwDecoderStepFoundSync;
         }
         break;
 
     case VwDecoderStepFoundSync:
-        if (DURATION_DIFF(duration, te_short) < te_delta)
+        if (pulse == ProtoPiratePulseShort)
         {
             // Stay - sync pattern repeats ~43 times
             break;
         }
 
-        if (level && DURATION_DIFF(duration, te_long) < te_delta)
+        if (level && pulse == ProtoPiratePulseLong)
         {
             instance->decoder.parser_step = VwDecoderStepFoundStart1;
             break;
@@ -279,7 +302,7 @@ void subghz_protocol_decoder_vw_feed(void *context, bool level, uint32_t duratio
         break;
 
     case VwDecoderStepFoundStart1:
-        if (!level && DURATION_DIFF(duration, te_short) < te_delta)
+        if (!level && pulse == ProtoPiratePulseShort)
         {
             instance->decoder.parser_step = VwDecoderStepFoundStart2;
             break;
@@ -305,7 +328,7 @@ void subghz_protocol_decoder_vw_feed(void *context, bool level, uint32_t duratio
             break;
         }
 
-        if (level && DURATION_DIFF(duration, te_short) < te_delta)
+        if (level && pulse == ProtoPiratePulseShort)
         {
             // Start data collection
             vw_manchester_advance(
@@ -329,12 +352,12 @@ void subghz_protocol_decoder_vw_feed(void *context, bool level, uint32_t duratio
         break;
 
     case VwDecoderStepFoundData:
-        if (DURATION_DIFF(duration, te_short) < te_delta)
+        if (pulse == ProtoPiratePulseShort)
         {
             event = level ? ManchesterEventShortHigh : ManchesterEventShortLow;
         }
 
-        if (DURATION_DIFF(duration, te_long) < te_delta)
+        if (pulse == ProtoPiratePulseLong)
         {
             event = level ? ManchesterEventLongHigh : ManchesterEventLongLow;
         }
@@ -366,6 +389,12 @@ void subghz_protocol_decoder_vw_feed(void *context, bool level, uint32_t duratio
     }
 }
 
+void subghz_protocol_decoder_vw_feed(void *context, bool level, uint32_t duration)
+{
+    subghz_protocol_decoder_vw_feed_pulse(
+        context, level, duration, protopirate_pulse_classify(&subghz_protocol_vw_const, duration));
+}
+
 uint8_t subghz_protocol_decoder_vw_get_hash_data(void *context)
 {
     furi_assert(context);
@@ -10,15 +10,23 @@
 #include <lib/subghz/blocks/math.h>
 #include <lib/toolbox/manchester_decoder.h>
 #include <flipper_format/flipper_format.h>
+#include "protocol_pulse.h"
 
 #define VW_PROTOCOL_NAME "VW"
 
 extern const SubGhzProtocol vw_protocol;
+extern const ProtoPirateDecoderExt vw_protocol_decoder_ext;
 
 void* subghz_protocol_decoder_vw_alloc(SubGhzEnvironment* environment);
 void subghz_protocol_decoder_vw_free(void* context);
 void subghz_protocol_decoder_vw_reset(void* context);
+bool subghz_protocol_decoder_vw_is_idle(void* context);
 void subghz_protocol_decoder_vw_feed(void* context, bool level, uint32_t duration);
+void subghz_protocol_decoder_vw_feed_pulse(
+    void* context,
+    bool level,
+    uint32_t duration,
+    ProtoPiratePulse pulse);
 uint8_t subghz_protocol_decoder_vw_get_hash_data(void* context);
 SubGhzProtocolStatus subghz_protocol_decoder_vw_serialize(
     void* context,
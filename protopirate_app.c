@@ -4,6 +4,7 @@
 #include <furi.h>
 #include <furi_hal.h>
 #include "protocols/protocol_items.h"
+#include "helpers/protopirate_storage.h"
 
 #define TAG "ProtoPirateApp"
 
@@ -11,9 +12,43 @@ static bool protopirate_app_custom_event_callback(void *context, uint32_t event)
 {
     furi_assert(context);
     ProtoPirateApp *app = context;
+
+    // Saves complete in the background, whichever scene is showing by then
+    if (event == ProtoPirateCustomEventStorageSaved ||
+        event == ProtoPirateCustomEventStorageArchived)
+    {
+        notification_message(app->notifications, &sequence_success);
+    }
+    else if (
+        event == ProtoPirateCustomEventStorageFailed ||
+        event == ProtoPirateCustomEventStorageArchiveFailed)
+    {
+        notification_message(app->notifications, &sequence_error);
+    }
+
     return scene_manager_handle_custom_event(app->scene_manager, event);
 }
 
+// Runs on the storage worker thread
+static void protopirate_app_storage_callback(
+    ProtoPirateStorageTarget target,
+    bool success,
+    void *context)
+{
+    ProtoPirateApp *app = context;
+    ProtoPirateCustomEvent event;
+    if (target == ProtoPirateStorageTargetUnpack || target == ProtoPirateStorageTargetPack)
+    {
+        event = success ? ProtoPirateCustomEventStorageArchived
+                        : ProtoPirateCustomEventStorageArchiveFailed;
+    }
+    else
+    {
+        event = success ? ProtoPirateCustomEventStorageSaved : ProtoPirateCustomEventStorageFailed;
+    }
+    view_dispatcher_send_custom_event(app->view_dispatcher, event);
+}
+
 static bool protopirate_app_back_event_callback(void *context)
 {
     furi_assert(context);
@@ -92,6 +127,13 @@ ProtoPirateApp *protopirate_app_alloc()
     // Init setting
     app->setting = subghz_setting_alloc();
     app->loaded_file_path = NULL;
+    app->capture = protopirate_capture_alloc();
+    protopirate_storage_index_alloc();
+    app->save_to_archive = false;
+    app->export_format = ProtoPirateExportFormatCsv;
+    app->storage_worker = protopirate_storage_worker_alloc();
+    protopirate_storage_worker_set_callback(
+        app->storage_worker, protopirate_app_storage_callback, app);
     subghz_setting_load(app->setting, EXT_PATH("subghz/assets/setting_user"));
 
     // Init Worker & Protocol & History
@@ -106,11 +148,26 @@ ProtoPirateApp *protopirate_app_alloc()
         app, "AM650", subghz_setting_get_default_frequency(app->setting), NULL, 0);
 
     app->txrx->hopper_state = ProtoPirateHopperStateOFF;
-    app->txrx->hopper_idx_frequency = 0;
+    app->txrx->hopper = protopirate_hopper_alloc(app->setting);
+    app->txrx->hopper_timer =
+        furi_timer_alloc(protopirate_hopper_timer_callback, FuriTimerTypePeriodic, app);
+    app->txrx->hopper_thread = protopirate_hopper_thread_alloc(app);
+    app->txrx->hopper_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    app->txrx->hopper_dwell = 100;
+    app->txrx->hopper_modulation = ProtoPirateHopperModulationPreset;
+    app->txrx->rx_tuning = PROTOPIRATE_HOPPER_PRESET_CURRENT;
+    protopirate_noise_floor_reset(&app->txrx->noise_floor);
     app->txrx->hopper_timeout = 0;
     app->txrx->idx_menu_chosen = 0;
 
-    app->txrx->history = protopirate_history_alloc();
+    app->txrx->history = protopirate_history_alloc(app->setting, KIA_HISTORY_MAX);
+    app->txrx->frame_ring = protopirate_frame_ring_alloc();
+    for (size_t i = 0; i < protopirate_protocol_ext_registry.size; i++)
+    {
+        furi_check(
+            protopirate_protocol_ext_registry.items[i]->decoder_size <=
+            PROTOPIRATE_FRAME_DECODER_SIZE);
+    }
     app->txrx->worker = subghz_worker_alloc();
 
     // Create environment with our custom protocols
@@ -122,6 +179,7 @@ ProtoPirateApp *protopirate_app_alloc()
 
     // Create receiver
     app->txrx->receiver = subghz_receiver_alloc_init(app->txrx->environment);
+    app->txrx->dispatch = protopirate_dispatch_alloc(app->txrx->receiver);
 
     // Initialize SubGhz devices
     subghz_devices_init();
@@ -154,14 +212,12 @@ ProtoPirateApp *protopirate_app_alloc()
     subghz_devices_idle(app->txrx->radio_device);
 
     // Set filter to accept decodable protocols
-    subghz_receiver_set_filter(app->txrx->receiver, SubGhzProtocolFlag_Decodable);
+    protopirate_dispatch_set_filter(app->txrx->dispatch, SubGhzProtocolFlag_Decodable);
 
-    // Set up worker callbacks
-    subghz_worker_set_overrun_callback(
-        app->txrx->worker, (SubGhzWorkerOverrunCallback)subghz_receiver_reset);
-    subghz_worker_set_pair_callback(
-        app->txrx->worker, (SubGhzWorkerPairCallback)subghz_receiver_decode);
-    subghz_worker_set_context(app->txrx->worker, app->txrx->receiver);
+    // Set up worker callbacks, pulses are classified once per timing family
+    subghz_worker_set_overrun_callback(app->txrx->worker, protopirate_dispatch_reset);
+    subghz_worker_set_pair_callback(app->txrx->worker, protopirate_dispatch_feed);
+    subghz_worker_set_context(app->txrx->worker, app->txrx->dispatch);
 
     furi_hal_power_suppress_charge_enter();
 
@@ -177,6 +233,7 @@ void protopirate_app_free(ProtoPirateApp *app)
     FURI_LOG_I(TAG, "Freeing ProtoPirate Decoder App");
 
     // Make sure we're not receiving
+    protopirate_hopper_timer_stop(app);
     if (app->txrx->txrx_state == ProtoPirateTxRxStateRx)
     {
         subghz_worker_stop(app->txrx->worker);
@@ -187,6 +244,7 @@ void protopirate_app_free(ProtoPirateApp *app)
     {
         furi_string_free(app->loaded_file_path);
     }
+    protopirate_capture_free(app->capture);
 
     subghz_devices_sleep(app->txrx->radio_device);
     radio_device_loader_end(app->txrx->radio_device);
@@ -221,14 +279,26 @@ void protopirate_app_free(ProtoPirateApp *app)
     subghz_setting_free(app->setting);
 
     // Worker & Protocol & History
+    protopirate_dispatch_free(app->txrx->dispatch);
     subghz_receiver_free(app->txrx->receiver);
     subghz_environment_free(app->txrx->environment);
     protopirate_history_free(app->txrx->history);
+    protopirate_frame_ring_free(app->txrx->frame_ring);
+    furi_timer_free(app->txrx->hopper_timer);
+    furi_thread_free(app->txrx->hopper_thread);
+    furi_mutex_free(app->txrx->hopper_mutex);
+    protopirate_hopper_free(app->txrx->hopper);
     subghz_worker_free(app->txrx->worker);
     furi_string_free(app->txrx->preset->name);
     free(app->txrx->preset);
     free(app->txrx);
 
+    // Storage worker, flushes queued saves and closes the session archive
+    protopirate_storage_worker_free(app->storage_worker);
+
+    // Saved captures index
+    protopirate_storage_index_free();
+
     // View dispatcher
     view_dispatcher_free(app->view_dispatcher);
     scene_manager_free(app->scene_manager);
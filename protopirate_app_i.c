@@ -3,6 +3,11 @@
 
 #define TAG "ProtoPirateTxRx"
 
+#define PROTOPIRATE_HOPPER_THREAD_STACK_SIZE 2048
+// Frequency unit in rx_tuning, finer than the CC1101 synthesizer step.
+// 928 MHz still fits the 24 bits left next to the preset index.
+#define PROTOPIRATE_RX_TUNING_STEP 100
+
 void protopirate_preset_init(
     void *context,
     const char *preset_name,
@@ -77,6 +82,63 @@ void protopirate_begin(ProtoPirateApp *app, uint8_t *preset_data)
     app->txrx->txrx_state = ProtoPirateTxRxStateIDLE;
 }
 
+// Only decoders that declare the band and modulation RX is on, or don't
+// declare them at all, are fed
+static void protopirate_rx_set_filter(ProtoPirateApp *app, uint32_t frequency)
+{
+    SubGhzProtocolFlag filter = SubGhzProtocolFlag_Decodable;
+    if (frequency >= 300000000 && frequency <= 348000000)
+    {
+        filter |= SubGhzProtocolFlag_315;
+    }
+    else if (frequency >= 387000000 && frequency <= 464000000)
+    {
+        filter |= SubGhzProtocolFlag_433;
+    }
+    else if (frequency >= 779000000 && frequency <= 928000000)
+    {
+        filter |= SubGhzProtocolFlag_868;
+    }
+
+    // Stock presets are named after their modulation, e.g. AM650 or FM476
+    const char *preset_name = furi_string_get_cstr(app->txrx->preset->name);
+    if (!strncmp(preset_name, "AM", 2))
+    {
+        filter |= SubGhzProtocolFlag_AM;
+    }
+    else if (!strncmp(preset_name, "FM", 2))
+    {
+        filter |= SubGhzProtocolFlag_FM;
+    }
+
+    uint8_t preset = PROTOPIRATE_HOPPER_PRESET_CURRENT;
+    for (size_t i = 0; i < subghz_setting_get_preset_count(app->setting) &&
+                       i < PROTOPIRATE_HOPPER_PRESET_CURRENT;
+         i++)
+    {
+        if (!strcmp(subghz_setting_get_preset_name(app->setting, i), preset_name))
+        {
+            preset = i;
+            break;
+        }
+    }
+    // One store, the worker never sees a frequency paired with a stale preset
+    __atomic_store_n(
+        &app->txrx->rx_tuning,
+        ((frequency / PROTOPIRATE_RX_TUNING_STEP) << 8) | preset,
+        __ATOMIC_RELEASE);
+
+    protopirate_dispatch_set_filter(app->txrx->dispatch, filter);
+}
+
+void protopirate_rx_get_tuning(ProtoPirateApp *app, uint32_t *frequency, uint8_t *preset)
+{
+    furi_assert(app);
+    uint32_t tuning = __atomic_load_n(&app->txrx->rx_tuning, __ATOMIC_ACQUIRE);
+    *frequency = (tuning >> 8) * PROTOPIRATE_RX_TUNING_STEP;
+    *preset = tuning & 0xFF;
+}
+
 uint32_t protopirate_rx(ProtoPirateApp *app, uint32_t frequency)
 {
     furi_assert(app);
@@ -88,6 +150,7 @@ uint32_t protopirate_rx(ProtoPirateApp *app, uint32_t frequency)
         app->txrx->txrx_state != ProtoPirateTxRxStateRx &&
         app->txrx->txrx_state != ProtoPirateTxRxStateSleep);
 
+    protopirate_rx_set_filter(app, frequency);
     subghz_devices_idle(app->txrx->radio_device);
     uint32_t value = subghz_devices_set_frequency(app->txrx->radio_device, frequency);
     subghz_devices_flush_rx(app->txrx->radio_device);
@@ -101,6 +164,30 @@ uint32_t protopirate_rx(ProtoPirateApp *app, uint32_t frequency)
     return value;
 }
 
+uint32_t protopirate_rx_retune(ProtoPirateApp *app, uint32_t frequency, uint8_t *preset_data)
+{
+    furi_assert(app);
+    furi_assert(app->txrx->txrx_state == ProtoPirateTxRxStateRx);
+    if (!subghz_devices_is_frequency_valid(app->txrx->radio_device, frequency))
+    {
+        furi_crash("ProtoPirate: Incorrect RX frequency.");
+    }
+
+    // Async RX and the worker keep running, only the radio settings change
+    subghz_devices_idle(app->txrx->radio_device);
+    if (preset_data)
+    {
+        subghz_devices_load_preset(
+            app->txrx->radio_device, FuriHalSubGhzPresetCustom, preset_data);
+    }
+    uint32_t value = subghz_devices_set_frequency(app->txrx->radio_device, frequency);
+    subghz_devices_flush_rx(app->txrx->radio_device);
+    subghz_devices_set_rx(app->txrx->radio_device);
+    protopirate_rx_set_filter(app, frequency);
+    protopirate_dispatch_retune(app->txrx->dispatch);
+    return value;
+}
+
 void protopirate_idle(ProtoPirateApp *app)
 {
     furi_assert(app);
@@ -129,63 +216,231 @@ void protopirate_sleep(ProtoPirateApp *app)
     app->txrx->txrx_state = ProtoPirateTxRxStateSleep;
 }
 
+static uint8_t protopirate_hopper_hold_ticks(ProtoPirateApp *app)
+{
+    return CLAMP(PROTOPIRATE_HOPPER_HOLD_MS / app->txrx->hopper_dwell, UINT8_MAX, 1);
+}
+
 void protopirate_hopper_update(ProtoPirateApp *app)
 {
     furi_assert(app);
 
+    const ProtoPirateHopperChannel *channel;
     switch (app->txrx->hopper_state)
     {
     case ProtoPirateHopperStateOFF:
-    case ProtoPirateHopperStatePause:
         return;
+    case ProtoPirateHopperStatePause:
     case ProtoPirateHopperStateRSSITimeOut:
+        // Hold the frequency, then move on without another RSSI check
         if (app->txrx->hopper_timeout != 0)
         {
             app->txrx->hopper_timeout--;
             return;
         }
+        app->txrx->hopper_state = ProtoPirateHopperStateRunning;
+        if (!protopirate_hopper_next(app->txrx->hopper, &channel))
+        {
+            return;
+        }
         break;
     default:
+    {
+        // The gate follows the noise floor of the channel
+        float rssi = subghz_devices_get_rssi(app->txrx->radio_device);
+        protopirate_hopper_add_rssi(app->txrx->hopper, rssi);
+        const ProtoPirateNoiseFloor *noise = protopirate_hopper_get_noise(app->txrx->hopper);
+        if (noise && rssi > protopirate_noise_floor_get_threshold(noise))
+        {
+            protopirate_hopper_add_pause(app->txrx->hopper);
+            app->txrx->hopper_timeout = protopirate_hopper_hold_ticks(app);
+            app->txrx->hopper_state = ProtoPirateHopperStateRSSITimeOut;
+            return;
+        }
+        if (!protopirate_hopper_tick(app->txrx->hopper, &channel))
+        {
+            return;
+        }
         break;
     }
-    float rssi = -127.0f;
-    if (app->txrx->hopper_state != ProtoPirateHopperStateRSSITimeOut)
+    }
+
+    uint8_t *preset_data = protopirate_hopper_load_preset(app, channel);
+    app->txrx->preset->frequency = channel->frequency;
+    if (app->txrx->txrx_state == ProtoPirateTxRxStateRx)
+    {
+        protopirate_rx_retune(app, channel->frequency, preset_data);
+    }
+    else if (app->txrx->txrx_state == ProtoPirateTxRxStateIDLE)
     {
-        rssi = subghz_devices_get_rssi(app->txrx->radio_device);
+        protopirate_dispatch_reset(app->txrx->dispatch);
+        if (preset_data)
+        {
+            protopirate_begin(app, preset_data);
+        }
+        protopirate_rx(app, app->txrx->preset->frequency);
+    }
+}
+
+uint8_t *
+protopirate_hopper_load_preset(ProtoPirateApp *app, const ProtoPirateHopperChannel *channel)
+{
+    furi_assert(app);
+    furi_assert(channel);
+
+    if (channel->preset == PROTOPIRATE_HOPPER_PRESET_CURRENT)
+    {
+        return NULL;
+    }
+    const char *preset_name = subghz_setting_get_preset_name(app->setting, channel->preset);
+    if (furi_string_equal_str(app->txrx->preset->name, preset_name))
+    {
+        return NULL;
+    }
+
+    uint8_t *preset_data = subghz_setting_get_preset_data(app->setting, channel->preset);
+    protopirate_preset_init(
+        app,
+        preset_name,
+        channel->frequency,
+        preset_data,
+        subghz_setting_get_preset_data_size(app->setting, channel->preset));
+    return preset_data;
+}
+
+void protopirate_hopper_set_modulation(
+    ProtoPirateApp *app,
+    ProtoPirateHopperModulation modulation)
+{
+    furi_assert(app);
 
-        if (rssi > -90.0f)
+    static const char *const names[] = {"AM650", "FM476"};
+    uint8_t presets[COUNT_OF(names)];
+    size_t count = 0;
+
+    if (modulation == ProtoPirateHopperModulationAmFm)
+    {
+        for (size_t i = 0; i < subghz_setting_get_preset_count(app->setting) &&
+                           i < PROTOPIRATE_HOPPER_PRESET_CURRENT;
+             i++)
         {
-            app->txrx->hopper_timeout = 10;
-            app->txrx->hopper_state = ProtoPirateHopperStateRSSITimeOut;
-            return;
+            const char *name = subghz_setting_get_preset_name(app->setting, i);
+            for (size_t j = 0; j < COUNT_OF(names); j++)
+            {
+                if (!strcmp(name, names[j]))
+                {
+                    presets[count++] = i;
+                }
+            }
         }
     }
-    else
+
+    if (count == 0)
     {
-        app->txrx->hopper_state = ProtoPirateHopperStateRunning;
+        // Preset mode, or a setting file without the stock presets
+        presets[count++] = PROTOPIRATE_HOPPER_PRESET_CURRENT;
     }
+    protopirate_hopper_set_presets(app->txrx->hopper, app->setting, presets, count);
+    app->txrx->hopper_modulation = modulation;
+}
 
-    if (app->txrx->hopper_idx_frequency <
-        subghz_setting_get_hopper_frequency_count(app->setting) - 1)
+typedef enum
+{
+    ProtoPirateHopperFlagTick = (1 << 0),
+    ProtoPirateHopperFlagExit = (1 << 1),
+} ProtoPirateHopperFlag;
+
+static int32_t protopirate_hopper_thread(void *context)
+{
+    ProtoPirateApp *app = context;
+
+    while (true)
     {
-        app->txrx->hopper_idx_frequency++;
+        uint32_t flags = furi_thread_flags_wait(
+            ProtoPirateHopperFlagTick | ProtoPirateHopperFlagExit,
+            FuriFlagWaitAny,
+            FuriWaitForever);
+        if ((flags & FuriFlagError) || (flags & ProtoPirateHopperFlagExit))
+        {
+            break;
+        }
+
+        furi_check(
+            furi_mutex_acquire(app->txrx->hopper_mutex, FuriWaitForever) == FuriStatusOk);
+        protopirate_hopper_mark(app->txrx->hopper, app->txrx->hopper_dwell * 1000);
+        protopirate_hopper_update(app);
+        furi_check(furi_mutex_release(app->txrx->hopper_mutex) == FuriStatusOk);
     }
-    else
+
+    return 0;
+}
+
+FuriThread *protopirate_hopper_thread_alloc(ProtoPirateApp *app)
+{
+    return furi_thread_alloc_ex(
+        "ProtoPirateHopper", PROTOPIRATE_HOPPER_THREAD_STACK_SIZE, protopirate_hopper_thread, app);
+}
+
+void protopirate_hopper_timer_callback(void *context)
+{
+    ProtoPirateApp *app = context;
+
+    // Radio writes block on SPI, keep them off the timer service thread
+    furi_thread_flags_set(
+        furi_thread_get_id(app->txrx->hopper_thread), ProtoPirateHopperFlagTick);
+}
+
+void protopirate_hopper_timer_start(ProtoPirateApp *app)
+{
+    furi_assert(app);
+    if (furi_thread_get_state(app->txrx->hopper_thread) == FuriThreadStateStopped)
     {
-        app->txrx->hopper_idx_frequency = 0;
+        furi_thread_start(app->txrx->hopper_thread);
     }
+    furi_timer_start(app->txrx->hopper_timer, furi_ms_to_ticks(app->txrx->hopper_dwell));
+}
 
-    if (app->txrx->txrx_state == ProtoPirateTxRxStateRx)
+void protopirate_hopper_timer_stop(ProtoPirateApp *app)
+{
+    furi_assert(app);
+    if (furi_timer_is_running(app->txrx->hopper_timer))
     {
-        protopirate_rx_end(app);
+        furi_timer_stop(app->txrx->hopper_timer);
     }
-    if (app->txrx->txrx_state == ProtoPirateTxRxStateIDLE)
+    // Returns once a running hop has finished
+    if (furi_thread_get_state(app->txrx->hopper_thread) != FuriThreadStateStopped)
     {
-        subghz_receiver_reset(app->txrx->receiver);
-        app->txrx->preset->frequency =
-            subghz_setting_get_hopper_frequency(app->setting, app->txrx->hopper_idx_frequency);
-        protopirate_rx(app, app->txrx->preset->frequency);
+        furi_thread_flags_set(
+            furi_thread_get_id(app->txrx->hopper_thread), ProtoPirateHopperFlagExit);
+        furi_thread_join(app->txrx->hopper_thread);
+    }
+}
+
+float protopirate_get_rssi(ProtoPirateApp *app)
+{
+    furi_assert(app);
+
+    // The hopper thread may be reprogramming the radio
+    furi_check(furi_mutex_acquire(app->txrx->hopper_mutex, FuriWaitForever) == FuriStatusOk);
+    float rssi = subghz_devices_get_rssi(app->txrx->radio_device);
+    furi_check(furi_mutex_release(app->txrx->hopper_mutex) == FuriStatusOk);
+
+    return rssi;
+}
+
+void protopirate_hopper_hit(ProtoPirateApp *app, uint32_t frequency, uint8_t preset)
+{
+    furi_assert(app);
+
+    furi_check(furi_mutex_acquire(app->txrx->hopper_mutex, FuriWaitForever) == FuriStatusOk);
+    protopirate_hopper_add_hit(app->txrx->hopper, frequency, preset);
+    // Stay a while, the remote usually repeats
+    if (app->txrx->hopper_state == ProtoPirateHopperStateRunning)
+    {
+        app->txrx->hopper_state = ProtoPirateHopperStatePause;
+        app->txrx->hopper_timeout = protopirate_hopper_hold_ticks(app);
     }
+    furi_check(furi_mutex_release(app->txrx->hopper_mutex) == FuriStatusOk);
 }
 
 void protopirate_tx(ProtoPirateApp *app, uint32_t frequency)
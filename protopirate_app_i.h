@@ -7,6 +7,12 @@
 #include "views/protopirate_receiver_info.h"
 #include "protopirate_history.h"
 #include "helpers/radio_device_loader.h"
+#include "helpers/protopirate_frame_ring.h"
+#include "helpers/protopirate_hopper.h"
+#include "helpers/protopirate_storage_worker.h"
+#include "helpers/protopirate_capture.h"
+#include "helpers/protopirate_export.h"
+#include "protocols/protocol_dispatch.h"
 
 #include <gui/gui.h>
 #include <gui/view_dispatcher.h>
@@ -28,14 +34,28 @@ typedef struct
     SubGhzWorker *worker;
     SubGhzEnvironment *environment;
     SubGhzReceiver *receiver;
+    ProtoPirateDispatch *dispatch;
     SubGhzRadioPreset *preset;
     ProtoPirateHistory *history;
+    ProtoPirateFrameRing *frame_ring;
     const SubGhzDevice *radio_device;
     ProtoPirateTxRxState txrx_state;
     ProtoPirateHopperState hopper_state;
     ProtoPirateRxKeyState rx_key_state;
-    uint8_t hopper_idx_frequency;
+    ProtoPirateHopper *hopper;
+    // The timer wakes the hopper thread, the mutex covers the hopper state
+    // and radio access shared with the GUI thread
+    FuriTimer *hopper_timer;
+    FuriThread *hopper_thread;
+    FuriMutex *hopper_mutex;
+    uint16_t hopper_dwell;
+    ProtoPirateHopperModulation hopper_modulation;
     uint8_t hopper_timeout;
+    // Frequency and setting index of the preset RX runs on, packed into one
+    // word for the worker thread, see protopirate_rx_get_tuning
+    uint32_t rx_tuning;
+    // Noise floor while not hopping, hopper channels keep their own
+    ProtoPirateNoiseFloor noise_floor;
     uint16_t idx_menu_chosen;
 } ProtoPirateTxRx;
 
@@ -55,6 +75,12 @@ struct ProtoPirateApp
     SubGhzSetting *setting;
     ProtoPirateLock lock;
     FuriString *loaded_file_path;
+    // Parsed loaded_file_path, shared by the saved info and emulate scenes
+    ProtoPirateCapture *capture;
+    // Saves go to one session archive instead of separate .sub files
+    bool save_to_archive;
+    ProtoPirateExportFormat export_format;
+    ProtoPirateStorageWorker *storage_worker;
 };
 
 void protopirate_preset_init(
@@ -73,9 +99,31 @@ void protopirate_get_frequency_modulation(
 
 void protopirate_begin(ProtoPirateApp *app, uint8_t *preset_data);
 uint32_t protopirate_rx(ProtoPirateApp *app, uint32_t frequency);
+// Moves a running RX to another frequency without restarting async RX.
+// preset_data switches the modulation too, NULL keeps it.
+uint32_t protopirate_rx_retune(ProtoPirateApp *app, uint32_t frequency, uint8_t *preset_data);
+// Frequency and preset RX was last tuned to, safe from any thread
+void protopirate_rx_get_tuning(ProtoPirateApp *app, uint32_t *frequency, uint8_t *preset);
 void protopirate_idle(ProtoPirateApp *app);
 void protopirate_rx_end(ProtoPirateApp *app);
 void protopirate_sleep(ProtoPirateApp *app);
 void protopirate_hopper_update(ProtoPirateApp *app);
+// Rebuilds the hop list, only while the hopper timer is stopped
+void protopirate_hopper_set_modulation(
+    ProtoPirateApp *app,
+    ProtoPirateHopperModulation modulation);
+// Loads the preset of a hop list channel into app->txrx->preset. Returns
+// its data, or NULL when the channel keeps the current preset.
+uint8_t *
+protopirate_hopper_load_preset(ProtoPirateApp *app, const ProtoPirateHopperChannel *channel);
+FuriThread *protopirate_hopper_thread_alloc(ProtoPirateApp *app);
+void protopirate_hopper_timer_callback(void *context);
+// Hops every hopper_dwell ms while RX runs, stop before ending RX
+void protopirate_hopper_timer_start(ProtoPirateApp *app);
+void protopirate_hopper_timer_stop(ProtoPirateApp *app);
+// A frame was decoded on frequency, holds the hopper there for a while
+void protopirate_hopper_hit(ProtoPirateApp *app, uint32_t frequency, uint8_t preset);
+// RSSI read serialized against hops
+float protopirate_get_rssi(ProtoPirateApp *app);
 void protopirate_tx(ProtoPirateApp *app, uint32_t frequency);
 void protopirate_tx_stop(ProtoPirateApp *app);
\ No newline at end of file
@@ -1,60 +1,289 @@
 // protopirate_history.c
 #include "protopirate_history.h"
+#include "protocols/protocol_items.h"
 #include <lib/subghz/receiver.h>
 #include <flipper_format/flipper_format_i.h>
+#include <toolbox/stream/stream.h>
+#include <storage/storage.h>
+#include <furi_hal.h>
 
 #define TAG "ProtoPirateHistory"
 
+#define PROTOPIRATE_HISTORY_PRESET_UNKNOWN 0xFF
+
+#define PROTOPIRATE_HISTORY_FLAG_PINNED (1 << 0)
+
+#define PROTOPIRATE_HISTORY_SNAPSHOT_MAGIC "PPHS"
+#define PROTOPIRATE_HISTORY_SNAPSHOT_VERSION 2
+
+// Followed by count records of stride bytes, oldest first
 typedef struct {
-    FuriString* item_str;
-    FlipperFormat* flipper_format;
-    uint8_t type;
-    SubGhzRadioPreset* preset;
-} ProtoPirateHistoryItem;
+    char magic[4];
+    uint16_t version;
+    uint16_t stride;
+    // Of the decoder registry the records were copied from
+    uint32_t fingerprint;
+    uint16_t count;
+    uint16_t last_index;
+} ProtoPirateHistorySnapshotHeader;
 
-ARRAY_DEF(ProtoPirateHistoryItemArray, ProtoPirateHistoryItem, M_POD_OPLIST)
+// Fixed-size binary record, a ring of them lives in one arena.
+// Text and FlipperFormat are only produced when an entry is shown or saved.
+typedef struct {
+    uint64_t key;
+    uint32_t frequency;
+    // RTC time of the last reception
+    uint32_t timestamp;
+    uint32_t serial;
+    uint32_t cnt;
+    uint16_t bits;
+    // Times the same frame was received while this entry was in history
+    uint16_t repeats;
+    uint8_t btn;
+    uint8_t protocol; // Index into protopirate_protocol_ext_registry
+    uint8_t preset; // Index into the SubGhzSetting preset list
+    int8_t rssi; // dBm
+    uint8_t flags;
+    // Copy of the decoder instance, sized by the largest registered decoder
+    uint64_t decoder[];
+} ProtoPirateHistoryRecord;
 
 struct ProtoPirateHistory {
-    ProtoPirateHistoryItemArray_t data;
+    SubGhzSetting* setting;
+    uint8_t* arena;
+    size_t stride;
+    uint16_t capacity;
+    // Physical slot of entry 0, entries wrap around the end of the arena
+    uint16_t head;
+    uint16_t count;
     uint16_t last_index;
-    uint32_t last_update_timestamp;
-    uint8_t code_last_hash_data;
+    // Open addressing over (protocol, payload), holds physical slots
+    uint16_t* index;
+    size_t index_mask;
+    // Scratch used to materialize a record on save/open
+    FlipperFormat* flipper_format;
+    SubGhzRadioPreset preset;
 };
 
-ProtoPirateHistory* protopirate_history_alloc(void) {
+static inline uint16_t protopirate_history_get_slot(ProtoPirateHistory* instance, uint16_t idx) {
+    size_t slot = instance->head + idx;
+    if(slot >= instance->capacity) {
+        slot -= instance->capacity;
+    }
+    return slot;
+}
+
+static inline ProtoPirateHistoryRecord*
+    protopirate_history_get_slot_record(ProtoPirateHistory* instance, uint16_t slot) {
+    return (ProtoPirateHistoryRecord*)(instance->arena + instance->stride * slot);
+}
+
+static inline ProtoPirateHistoryRecord*
+    protopirate_history_get_record(ProtoPirateHistory* instance, uint16_t idx) {
+    return protopirate_history_get_slot_record(
+        instance, protopirate_history_get_slot(instance, idx));
+}
+
+// Decoder payload kept outside SubGhzBlockGeneric, inside the record's copy
+static inline const uint8_t*
+    protopirate_history_record_payload(const ProtoPirateHistoryRecord* record) {
+    const ProtoPirateDecoderExt* ext = protopirate_protocol_ext_registry.items[record->protocol];
+    return (const uint8_t*)record->decoder + ext->payload_offset;
+}
+
+// b is compared with its payload given separately, it may not hold a decoder copy yet
+static inline bool protopirate_history_record_equal(
+    const ProtoPirateHistoryRecord* a,
+    const ProtoPirateHistoryRecord* b,
+    const uint8_t* b_payload) {
+    return a->key == b->key && a->bits == b->bits && a->protocol == b->protocol &&
+           a->serial == b->serial && a->cnt == b->cnt && a->btn == b->btn &&
+           !memcmp(
+               protopirate_history_record_payload(a),
+               b_payload,
+               protopirate_protocol_ext_registry.items[a->protocol]->payload_size);
+}
+
+static size_t protopirate_history_index_bucket(
+    ProtoPirateHistory* instance,
+    const ProtoPirateHistoryRecord* record,
+    const uint8_t* payload) {
+    uint64_t h = record->key ^ ((uint64_t)record->protocol << 56) ^
+                 ((uint64_t)record->bits << 40) ^ ((uint64_t)record->serial << 8) ^
+                 record->cnt ^ record->btn;
+    size_t payload_size = protopirate_protocol_ext_registry.items[record->protocol]->payload_size;
+    for(size_t i = 0; i < payload_size; i++) {
+        h = (h ^ payload[i]) * 0x100000001b3ULL;
+    }
+    // splitmix64 finalizer, spreads nearby rolling codes across buckets
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h & instance->index_mask;
+}
+
+// Bucket holding an entry equal to record, or the empty bucket ending its probe
+static size_t protopirate_history_index_find(
+    ProtoPirateHistory* instance,
+    const ProtoPirateHistoryRecord* record,
+    const uint8_t* payload) {
+    size_t bucket = protopirate_history_index_bucket(instance, record, payload);
+    while(instance->index[bucket] != PROTOPIRATE_HISTORY_NONE &&
+          !protopirate_history_record_equal(
+              protopirate_history_get_slot_record(instance, instance->index[bucket]),
+              record,
+              payload)) {
+        bucket = (bucket + 1) & instance->index_mask;
+    }
+    return bucket;
+}
+
+// Bucket pointing at a slot that is known to be indexed
+static size_t protopirate_history_index_find_slot(ProtoPirateHistory* instance, uint16_t slot) {
+    const ProtoPirateHistoryRecord* record = protopirate_history_get_slot_record(instance, slot);
+    size_t bucket = protopirate_history_index_bucket(
+        instance, record, protopirate_history_record_payload(record));
+    while(instance->index[bucket] != slot) {
+        furi_assert(instance->index[bucket] != PROTOPIRATE_HISTORY_NONE);
+        bucket = (bucket + 1) & instance->index_mask;
+    }
+    return bucket;
+}
+
+// Backward-shift deletion, keeps probe chains intact without tombstones
+static void protopirate_history_index_remove(ProtoPirateHistory* instance, uint16_t slot) {
+    size_t hole = protopirate_history_index_find_slot(instance, slot);
+    size_t bucket = hole;
+    while(true) {
+        bucket = (bucket + 1) & instance->index_mask;
+        uint16_t moved = instance->index[bucket];
+        if(moved == PROTOPIRATE_HISTORY_NONE) {
+            break;
+        }
+        const ProtoPirateHistoryRecord* record =
+            protopirate_history_get_slot_record(instance, moved);
+        size_t home = protopirate_history_index_bucket(
+            instance, record, protopirate_history_record_payload(record));
+        // Move it into the hole unless its home lies cyclically in (hole, bucket]
+        if(((bucket - home) & instance->index_mask) >= ((bucket - hole) & instance->index_mask)) {
+            instance->index[hole] = moved;
+            hole = bucket;
+        }
+    }
+    instance->index[hole] = PROTOPIRATE_HISTORY_NONE;
+}
+
+static void protopirate_history_index_clear(ProtoPirateHistory* instance) {
+    memset(instance->index, 0xFF, sizeof(uint16_t) * (instance->index_mask + 1));
+}
+
+// Frees a slot in a full ring by dropping the oldest unpinned entry. Pinned
+// entries in front of it move up one slot, so entry order is preserved.
+static uint16_t protopirate_history_evict(ProtoPirateHistory* instance) {
+    uint16_t victim = 0;
+    while(victim < instance->count &&
+          (protopirate_history_get_record(instance, victim)->flags &
+           PROTOPIRATE_HISTORY_FLAG_PINNED)) {
+        victim++;
+    }
+    if(victim == instance->count) {
+        return PROTOPIRATE_HISTORY_NONE;
+    }
+
+    protopirate_history_index_remove(instance, protopirate_history_get_slot(instance, victim));
+    for(uint16_t i = victim; i > 0; i--) {
+        uint16_t from = protopirate_history_get_slot(instance, i - 1);
+        uint16_t to = protopirate_history_get_slot(instance, i);
+        instance->index[protopirate_history_index_find_slot(instance, from)] = to;
+        memcpy(
+            protopirate_history_get_slot_record(instance, to),
+            protopirate_history_get_slot_record(instance, from),
+            instance->stride);
+    }
+    instance->head = (instance->head + 1) % instance->capacity;
+    instance->count--;
+    return victim;
+}
+
+static inline SubGhzProtocolDecoderBase*
+    protopirate_history_get_record_decoder(ProtoPirateHistoryRecord* record) {
+    return (SubGhzProtocolDecoderBase*)record->decoder;
+}
+
+static uint8_t protopirate_history_find_preset(SubGhzSetting* setting, const char* name) {
+    // subghz_setting_get_inx_preset_by_name crashes on unknown names
+    size_t count = subghz_setting_get_preset_count(setting);
+    for(size_t i = 0; i < count && i < PROTOPIRATE_HISTORY_PRESET_UNKNOWN; i++) {
+        if(!strcmp(subghz_setting_get_preset_name(setting, i), name)) {
+            return i;
+        }
+    }
+    return PROTOPIRATE_HISTORY_PRESET_UNKNOWN;
+}
+
+ProtoPirateHistory* protopirate_history_alloc(SubGhzSetting* setting, uint16_t capacity) {
+    furi_assert(setting);
+    furi_assert(capacity > 0 && capacity < PROTOPIRATE_HISTORY_NONE);
     ProtoPirateHistory* instance = malloc(sizeof(ProtoPirateHistory));
-    ProtoPirateHistoryItemArray_init(instance->data);
+    instance->setting = setting;
+
+    size_t decoder_size = 0;
+    for(size_t i = 0; i < protopirate_protocol_ext_registry.size; i++) {
+        if(protopirate_protocol_ext_registry.items[i]->decoder_size > decoder_size) {
+            decoder_size = protopirate_protocol_ext_registry.items[i]->decoder_size;
+        }
+    }
+    instance->stride = sizeof(ProtoPirateHistoryRecord) +
+                       (decoder_size + sizeof(uint64_t) - 1) / sizeof(uint64_t) *
+                           sizeof(uint64_t);
+    instance->capacity = capacity;
+    instance->arena = malloc(instance->stride * capacity);
+    FURI_LOG_I(TAG, "Arena: %u x %u bytes", capacity, instance->stride);
+
+    // Load factor stays at or below one half
+    size_t index_size = 1;
+    while(index_size < (size_t)capacity * 2) {
+        index_size <<= 1;
+    }
+    instance->index = malloc(sizeof(uint16_t) * index_size);
+    instance->index_mask = index_size - 1;
+    protopirate_history_index_clear(instance);
+
+    instance->head = 0;
+    instance->count = 0;
     instance->last_index = 0;
+    instance->flipper_format = flipper_format_string_alloc();
+    instance->preset.name = furi_string_alloc();
     return instance;
 }
 
 void protopirate_history_free(ProtoPirateHistory* instance) {
     furi_assert(instance);
-    for(size_t i = 0; i < ProtoPirateHistoryItemArray_size(instance->data); i++) {
-        ProtoPirateHistoryItem* item = ProtoPirateHistoryItemArray_get(instance->data, i);
-        furi_string_free(item->item_str);
-        flipper_format_free(item->flipper_format);
-        free(item->preset);
-    }
-    ProtoPirateHistoryItemArray_clear(instance->data);
+    flipper_format_free(instance->flipper_format);
+    furi_string_free(instance->preset.name);
+    free(instance->index);
+    free(instance->arena);
     free(instance);
 }
 
 void protopirate_history_reset(ProtoPirateHistory* instance) {
     furi_assert(instance);
-    for(size_t i = 0; i < ProtoPirateHistoryItemArray_size(instance->data); i++) {
-        ProtoPirateHistoryItem* item = ProtoPirateHistoryItemArray_get(instance->data, i);
-        furi_string_free(item->item_str);
-        flipper_format_free(item->flipper_format);
-        free(item->preset);
-    }
-    ProtoPirateHistoryItemArray_reset(instance->data);
+    instance->head = 0;
+    instance->count = 0;
     instance->last_index = 0;
+    protopirate_history_index_clear(instance);
 }
 
 uint16_t protopirate_history_get_item(ProtoPirateHistory* instance) {
     furi_assert(instance);
-    return ProtoPirateHistoryItemArray_size(instance->data);
+    return instance->count;
+}
+
+uint16_t protopirate_history_get_capacity(ProtoPirateHistory* instance) {
+    furi_assert(instance);
+    return instance->capacity;
 }
 
 uint16_t protopirate_history_get_last_index(ProtoPirateHistory* instance) {
@@ -65,67 +294,138 @@ uint16_t protopirate_history_get_last_index(ProtoPirateHistory* instance) {
 bool protopirate_history_add_to_history(
     ProtoPirateHistory* instance,
     void* context,
-    SubGhzRadioPreset* preset) {
+    SubGhzRadioPreset* preset,
+    float rssi,
+    uint32_t timestamp,
+    uint16_t* evicted) {
     furi_assert(instance);
     furi_assert(context);
+    furi_assert(evicted);
+
+    *evicted = PROTOPIRATE_HISTORY_NONE;
+    SubGhzProtocolDecoderBase* decoder_base = context;
 
-    if(ProtoPirateHistoryItemArray_size(instance->data) >= KIA_HISTORY_MAX) {
+    size_t protocol = 0;
+    while(protocol < protopirate_protocol_ext_registry.size &&
+          protopirate_protocol_ext_registry.items[protocol]->protocol != decoder_base->protocol) {
+        protocol++;
+    }
+    if(protocol == protopirate_protocol_ext_registry.size) {
+        FURI_LOG_E(TAG, "Unregistered protocol %s", decoder_base->protocol->name);
         return false;
     }
-
-    SubGhzProtocolDecoderBase* decoder_base = context;
-    if((instance->code_last_hash_data ==
-        subghz_protocol_decoder_base_get_hash_data(decoder_base)) &&
-       ((furi_get_tick() - instance->last_update_timestamp) < 500)) {
-        instance->last_update_timestamp = furi_get_tick();
+    const ProtoPirateDecoderExt* ext = protopirate_protocol_ext_registry.items[protocol];
+
+    // Fill the lookup fields first, the index compares them and the payload
+    const SubGhzBlockGeneric* generic =
+        (const SubGhzBlockGeneric*)((const uint8_t*)decoder_base + ext->generic_offset);
+    ProtoPirateHistoryRecord frame = {
+        .key = generic->data,
+        .serial = generic->serial,
+        .cnt = generic->cnt,
+        .bits = generic->data_count_bit,
+        .btn = generic->btn,
+        .protocol = protocol,
+    };
+    const uint8_t* payload = (const uint8_t*)decoder_base + ext->payload_offset;
+    int8_t rssi_dbm = rssi < -128.0f ? -128 : (rssi > 0.0f ? 0 : (int8_t)rssi);
+
+    size_t bucket = protopirate_history_index_find(instance, &frame, payload);
+    if(instance->index[bucket] != PROTOPIRATE_HISTORY_NONE) {
+        ProtoPirateHistoryRecord* record =
+            protopirate_history_get_slot_record(instance, instance->index[bucket]);
+        if(record->repeats < UINT16_MAX) {
+            record->repeats++;
+        }
+        record->timestamp = timestamp;
+        record->rssi = rssi_dbm;
         return false;
     }
 
-    instance->code_last_hash_data = subghz_protocol_decoder_base_get_hash_data(decoder_base);
-    instance->last_update_timestamp = furi_get_tick();
+    if(instance->count == instance->capacity) {
+        *evicted = protopirate_history_evict(instance);
+        if(*evicted == PROTOPIRATE_HISTORY_NONE) {
+            FURI_LOG_W(TAG, "History full of pinned entries");
+            return false;
+        }
+        // Eviction may have shifted the probe chain this frame would land in
+        bucket = protopirate_history_index_find(instance, &frame, payload);
+    }
+
+    uint16_t slot = protopirate_history_get_slot(instance, instance->count);
+    ProtoPirateHistoryRecord* record = protopirate_history_get_slot_record(instance, slot);
+    *record = frame;
+    memcpy(record->decoder, decoder_base, ext->decoder_size);
+    record->preset =
+        protopirate_history_find_preset(instance->setting, furi_string_get_cstr(preset->name));
+    record->frequency = preset->frequency;
+    record->timestamp = timestamp;
+    record->repeats = 1;
+    record->rssi = rssi_dbm;
+    record->flags = 0;
+    instance->index[bucket] = slot;
+
+    instance->count++;
+    instance->last_index++;
+
+    FURI_LOG_I(
+        TAG,
+        "Added item %u to history: %s, %u bit",
+        instance->last_index,
+        decoder_base->protocol->name,
+        record->bits);
 
-    // Create a new history item
-    ProtoPirateHistoryItem* item = ProtoPirateHistoryItemArray_push_raw(instance->data);
-    item->item_str = furi_string_alloc();
-    item->flipper_format = flipper_format_string_alloc();
-    item->type = 0;
+    return true;
+}
 
-    // Copy preset
-    item->preset = malloc(sizeof(SubGhzRadioPreset));
-    item->preset->frequency = preset->frequency;
-    item->preset->name = furi_string_alloc();
-    furi_string_set(item->preset->name, preset->name);
-    item->preset->data = preset->data;
-    item->preset->data_size = preset->data_size;
+void protopirate_history_set_pinned(ProtoPirateHistory* instance, uint16_t idx, bool pinned) {
+    furi_assert(instance);
 
-    // Get string representation
-    FuriString* text = furi_string_alloc();
-    subghz_protocol_decoder_base_get_string(decoder_base, text);
-    furi_string_set(item->item_str, text);
+    if(idx >= instance->count) {
+        return;
+    }
 
-    // Serialize to flipper format
-    subghz_protocol_decoder_base_serialize(decoder_base, item->flipper_format, preset);
-    
-    // Debug: Log what we're adding to history
-    flipper_format_rewind(item->flipper_format);
-    uint32_t debug_bit_count;
-    FuriString* debug_protocol = furi_string_alloc();
-    if (flipper_format_read_string(item->flipper_format, "Protocol", debug_protocol)) {
-        FURI_LOG_I(TAG, "History add - Protocol: %s", furi_string_get_cstr(debug_protocol));
+    ProtoPirateHistoryRecord* record = protopirate_history_get_record(instance, idx);
+    if(pinned) {
+        record->flags |= PROTOPIRATE_HISTORY_FLAG_PINNED;
+    } else {
+        record->flags &= ~PROTOPIRATE_HISTORY_FLAG_PINNED;
     }
-    flipper_format_rewind(item->flipper_format);
-    if (flipper_format_read_uint32(item->flipper_format, "Bit", &debug_bit_count, 1)) {
-        FURI_LOG_I(TAG, "History add - Bit count: %lu", debug_bit_count);
+}
+
+bool protopirate_history_is_pinned(ProtoPirateHistory* instance, uint16_t idx) {
+    furi_assert(instance);
+
+    if(idx >= instance->count) {
+        return false;
     }
-    furi_string_free(debug_protocol);
 
-    furi_string_free(text);
+    return protopirate_history_get_record(instance, idx)->flags & PROTOPIRATE_HISTORY_FLAG_PINNED;
+}
 
-    instance->last_index++;
+const char* protopirate_history_get_name(ProtoPirateHistory* instance, uint16_t idx) {
+    furi_assert(instance);
 
-    FURI_LOG_I(TAG, "Added item %u to history", instance->last_index);
+    if(idx >= instance->count) {
+        return "---";
+    }
 
-    return true;
+    ProtoPirateHistoryRecord* record = protopirate_history_get_record(instance, idx);
+    const ProtoPirateDecoderExt* ext = protopirate_protocol_ext_registry.items[record->protocol];
+    if(ext->get_name) {
+        return ext->get_name(record->decoder);
+    }
+    return ext->protocol->name;
+}
+
+uint16_t protopirate_history_get_bits(ProtoPirateHistory* instance, uint16_t idx) {
+    furi_assert(instance);
+
+    if(idx >= instance->count) {
+        return 0;
+    }
+
+    return protopirate_history_get_record(instance, idx)->bits;
 }
 
 void protopirate_history_get_text_item_menu(
@@ -135,28 +435,17 @@ void protopirate_history_get_text_item_menu(
     furi_assert(instance);
     furi_assert(output);
 
-    if(idx >= ProtoPirateHistoryItemArray_size(instance->data)) {
+    if(idx >= instance->count) {
         furi_string_set(output, "---");
         return;
     }
 
-    ProtoPirateHistoryItem* item = ProtoPirateHistoryItemArray_get(instance->data, idx);
-
-    // Get just the first line for the menu
-    const char* str = furi_string_get_cstr(item->item_str);
-    const char* newline = strchr(str, '\r');
-    if(newline) {
-        size_t len = newline - str;
-        furi_string_set_strn(output, str, len);
-    } else {
-        newline = strchr(str, '\n');
-        if(newline) {
-            size_t len = newline - str;
-            furi_string_set_strn(output, str, len);
-        } else {
-            furi_string_set(output, item->item_str);
-        }
-    }
+    // Same as the first line of get_string, built from the stored fields
+    furi_string_printf(
+        output,
+        "%s %ubit",
+        protopirate_history_get_name(instance, idx),
+        protopirate_history_get_bits(instance, idx));
 }
 
 void protopirate_history_get_text_item(
@@ -166,29 +455,214 @@ void protopirate_history_get_text_item(
     furi_assert(instance);
     furi_assert(output);
 
-    if(idx >= ProtoPirateHistoryItemArray_size(instance->data)) {
+    if(idx >= instance->count) {
         furi_string_set(output, "---");
         return;
     }
 
-    ProtoPirateHistoryItem* item = ProtoPirateHistoryItemArray_get(instance->data, idx);
-    furi_string_set(output, item->item_str);
+    ProtoPirateHistoryRecord* record = protopirate_history_get_record(instance, idx);
+    furi_string_reset(output);
+    subghz_protocol_decoder_base_get_string(
+        protopirate_history_get_record_decoder(record), output);
+    if(record->repeats > 1) {
+        furi_string_cat_printf(output, "\r\nRepeats: %u", record->repeats);
+    }
+}
+
+void protopirate_history_get_entry(
+    ProtoPirateHistory* instance,
+    uint16_t idx,
+    ProtoPirateHistoryEntry* entry) {
+    furi_assert(instance);
+    furi_assert(entry);
+    furi_assert(idx < instance->count);
+
+    ProtoPirateHistoryRecord* record = protopirate_history_get_record(instance, idx);
+    entry->name = protopirate_history_get_name(instance, idx);
+    entry->key = record->key;
+    entry->bits = record->bits;
+    entry->serial = record->serial;
+    entry->btn = record->btn;
+    entry->cnt = record->cnt;
+    entry->frequency = record->frequency;
+    entry->preset = record->preset != PROTOPIRATE_HISTORY_PRESET_UNKNOWN ?
+                        subghz_setting_get_preset_name(instance->setting, record->preset) :
+                        NULL;
+    entry->timestamp = record->timestamp;
+    entry->rssi = record->rssi;
+    entry->repeats = record->repeats;
+}
+
+uint16_t protopirate_history_get_repeats(ProtoPirateHistory* instance, uint16_t idx) {
+    furi_assert(instance);
+
+    if(idx >= instance->count) {
+        return 0;
+    }
+
+    return protopirate_history_get_record(instance, idx)->repeats;
 }
 
 SubGhzProtocolDecoderBase*
     protopirate_history_get_decoder_base(ProtoPirateHistory* instance, uint16_t idx) {
-    UNUSED(instance);
-    UNUSED(idx);
-    return NULL;
+    furi_assert(instance);
+
+    if(idx >= instance->count) {
+        return NULL;
+    }
+
+    return protopirate_history_get_record_decoder(protopirate_history_get_record(instance, idx));
+}
+
+// Records hold raw decoder copies, they only load into the build that wrote them
+static uint32_t protopirate_history_fingerprint(ProtoPirateHistory* instance) {
+    // FNV-1a over protocol names and decoder layouts
+    uint32_t hash = 2166136261u;
+    for(size_t i = 0; i < protopirate_protocol_ext_registry.size; i++) {
+        const ProtoPirateDecoderExt* ext = protopirate_protocol_ext_registry.items[i];
+        for(const char* c = ext->protocol->name; *c; c++) {
+            hash = (hash ^ (uint8_t)*c) * 16777619u;
+        }
+        hash = (hash ^ ext->decoder_size) * 16777619u;
+        hash = (hash ^ ext->generic_offset) * 16777619u;
+    }
+    return (hash ^ instance->stride) * 16777619u;
+}
+
+bool protopirate_history_save(ProtoPirateHistory* instance, const char* path) {
+    furi_assert(instance);
+    furi_assert(path);
+
+    ProtoPirateHistorySnapshotHeader header = {
+        .magic = PROTOPIRATE_HISTORY_SNAPSHOT_MAGIC,
+        .version = PROTOPIRATE_HISTORY_SNAPSHOT_VERSION,
+        .stride = instance->stride,
+        .fingerprint = protopirate_history_fingerprint(instance),
+        .count = instance->count,
+        .last_index = instance->last_index,
+    };
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    bool result = false;
+
+    if(storage_file_open(file, path, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        // The ring is written as at most two contiguous runs of the arena
+        size_t first = MIN(instance->count, instance->capacity - instance->head);
+        size_t first_size = first * instance->stride;
+        size_t second_size = (instance->count - first) * instance->stride;
+        result = storage_file_write(file, &header, sizeof(header)) == sizeof(header) &&
+                 storage_file_write(
+                     file, instance->arena + instance->head * instance->stride, first_size) ==
+                     first_size &&
+                 storage_file_write(file, instance->arena, second_size) == second_size;
+    }
+
+    storage_file_close(file);
+    storage_file_free(file);
+    if(!result) {
+        FURI_LOG_E(TAG, "Failed to write snapshot");
+        storage_simply_remove(storage, path);
+    }
+    furi_record_close(RECORD_STORAGE);
+    return result;
+}
+
+bool protopirate_history_load(ProtoPirateHistory* instance, const char* path) {
+    furi_assert(instance);
+    furi_assert(path);
+
+    protopirate_history_reset(instance);
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    ProtoPirateHistorySnapshotHeader header;
+    bool result = false;
+
+    do {
+        if(!storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING)) break;
+        if(storage_file_read(file, &header, sizeof(header)) != sizeof(header)) break;
+        if(memcmp(header.magic, PROTOPIRATE_HISTORY_SNAPSHOT_MAGIC, sizeof(header.magic)) ||
+           header.version != PROTOPIRATE_HISTORY_SNAPSHOT_VERSION ||
+           header.stride != instance->stride ||
+           header.fingerprint != protopirate_history_fingerprint(instance)) {
+            FURI_LOG_W(TAG, "Snapshot from another build, ignored");
+            break;
+        }
+
+        // Keep the newest entries if the snapshot holds more than fit
+        uint16_t count = MIN(header.count, instance->capacity);
+        if(count < header.count &&
+           !storage_file_seek(file, (header.count - count) * instance->stride, false))
+            break;
+        size_t size = count * instance->stride;
+        if(storage_file_read(file, instance->arena, size) != size) break;
+
+        size_t preset_count = subghz_setting_get_preset_count(instance->setting);
+        for(uint16_t slot = 0; slot < count; slot++) {
+            ProtoPirateHistoryRecord* record = protopirate_history_get_slot_record(instance, slot);
+            if(record->protocol >= protopirate_protocol_ext_registry.size) break;
+            const ProtoPirateDecoderExt* ext =
+                protopirate_protocol_ext_registry.items[record->protocol];
+
+            // Pointers in the copy belong to the session that wrote it
+            SubGhzProtocolDecoderBase* decoder_base = protopirate_history_get_record_decoder(record);
+            decoder_base->protocol = ext->protocol;
+            decoder_base->callback = NULL;
+            decoder_base->context = NULL;
+            SubGhzBlockGeneric* generic =
+                (SubGhzBlockGeneric*)((uint8_t*)decoder_base + ext->generic_offset);
+            generic->protocol_name = ext->protocol->name;
+
+            if(record->preset >= preset_count) {
+                record->preset = PROTOPIRATE_HISTORY_PRESET_UNKNOWN;
+            }
+
+            instance->index[protopirate_history_index_find(
+                instance, record, protopirate_history_record_payload(record))] = slot;
+            instance->count++;
+        }
+
+        instance->last_index = MAX(header.last_index, instance->count);
+        result = instance->count == count;
+    } while(false);
+
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+
+    if(!result) {
+        protopirate_history_reset(instance);
+    }
+    FURI_LOG_I(TAG, "Snapshot restored %u entries", instance->count);
+    return result;
 }
 
 FlipperFormat* protopirate_history_get_raw_data(ProtoPirateHistory* instance, uint16_t idx) {
     furi_assert(instance);
 
-    if(idx >= ProtoPirateHistoryItemArray_size(instance->data)) {
+    if(idx >= instance->count) {
         return NULL;
     }
 
-    ProtoPirateHistoryItem* item = ProtoPirateHistoryItemArray_get(instance->data, idx);
-    return item->flipper_format;
+    ProtoPirateHistoryRecord* record = protopirate_history_get_record(instance, idx);
+
+    SubGhzRadioPreset* preset = &instance->preset;
+    preset->frequency = record->frequency;
+    if(record->preset != PROTOPIRATE_HISTORY_PRESET_UNKNOWN) {
+        furi_string_set(
+            preset->name, subghz_setting_get_preset_name(instance->setting, record->preset));
+        preset->data = subghz_setting_get_preset_data(instance->setting, record->preset);
+        preset->data_size = subghz_setting_get_preset_data_size(instance->setting, record->preset);
+    } else {
+        furi_string_set(preset->name, "AM650");
+        preset->data = NULL;
+        preset->data_size = 0;
+    }
+
+    stream_clean(flipper_format_get_raw_stream(instance->flipper_format));
+    subghz_protocol_decoder_base_serialize(
+        protopirate_history_get_record_decoder(record), instance->flipper_format, preset);
+    flipper_format_rewind(instance->flipper_format);
+    return instance->flipper_format;
 }
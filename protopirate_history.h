@@ -3,20 +3,59 @@
 
 #include <lib/subghz/receiver.h>
 #include <lib/subghz/protocols/base.h>
+#include <lib/subghz/subghz_setting.h>
 
-#define KIA_HISTORY_MAX 50
+// Default capacity, oldest unpinned entries are evicted once it is reached
+#define KIA_HISTORY_MAX 128
+
+// No entry, e.g. nothing was evicted by protopirate_history_add_to_history
+#define PROTOPIRATE_HISTORY_NONE UINT16_MAX
 
 typedef struct ProtoPirateHistory ProtoPirateHistory;
 
-ProtoPirateHistory* protopirate_history_alloc(void);
+// Stored fields of an entry, strings are static or owned by the setting
+typedef struct {
+    const char* name;
+    uint64_t key;
+    uint16_t bits;
+    uint32_t serial;
+    uint8_t btn;
+    uint32_t cnt;
+    uint32_t frequency;
+    const char* preset; // NULL if not in the setting
+    uint32_t timestamp; // RTC time of the last reception
+    int8_t rssi;
+    uint16_t repeats;
+} ProtoPirateHistoryEntry;
+
+ProtoPirateHistory* protopirate_history_alloc(SubGhzSetting* setting, uint16_t capacity);
 void protopirate_history_free(ProtoPirateHistory* instance);
 void protopirate_history_reset(ProtoPirateHistory* instance);
 uint16_t protopirate_history_get_item(ProtoPirateHistory* instance);
+uint16_t protopirate_history_get_capacity(ProtoPirateHistory* instance);
 uint16_t protopirate_history_get_last_index(ProtoPirateHistory* instance);
+// Index 0 is the oldest entry. A frame already in history only bumps that
+// entry's repeat count and returns false. When full, the oldest unpinned
+// entry is evicted first and its index stored in *evicted
+// (PROTOPIRATE_HISTORY_NONE otherwise), later entries shift down by one.
+// rssi and timestamp are taken when the frame was received.
 bool protopirate_history_add_to_history(
     ProtoPirateHistory* instance,
     void* context,
-    SubGhzRadioPreset* preset);
+    SubGhzRadioPreset* preset,
+    float rssi,
+    uint32_t timestamp,
+    uint16_t* evicted);
+void protopirate_history_set_pinned(ProtoPirateHistory* instance, uint16_t idx, bool pinned);
+bool protopirate_history_is_pinned(ProtoPirateHistory* instance, uint16_t idx);
+uint16_t protopirate_history_get_repeats(ProtoPirateHistory* instance, uint16_t idx);
+// Static name of the protocol or variant, e.g. "Kia V3"
+const char* protopirate_history_get_name(ProtoPirateHistory* instance, uint16_t idx);
+uint16_t protopirate_history_get_bits(ProtoPirateHistory* instance, uint16_t idx);
+void protopirate_history_get_entry(
+    ProtoPirateHistory* instance,
+    uint16_t idx,
+    ProtoPirateHistoryEntry* entry);
 void protopirate_history_get_text_item_menu(
     ProtoPirateHistory* instance,
     FuriString* output,
@@ -27,4 +66,11 @@ void protopirate_history_get_text_item(
     uint16_t idx);
 SubGhzProtocolDecoderBase*
     protopirate_history_get_decoder_base(ProtoPirateHistory* instance, uint16_t idx);
+// Binary snapshot of every entry, restored without a FlipperFormat round trip
+bool protopirate_history_save(ProtoPirateHistory* instance, const char* path);
+// Replaces the current entries. Snapshots written by a build with other
+// decoder layouts are rejected.
+bool protopirate_history_load(ProtoPirateHistory* instance, const char* path);
+// Serialized on demand into a FlipperFormat owned by the history,
+// valid until the next call
 FlipperFormat* protopirate_history_get_raw_data(ProtoPirateHistory* instance, uint16_t idx);
@@ -10,9 +10,15 @@ typedef struct
     uint32_t original_counter;
     uint32_t current_counter;
     uint32_t serial;
+    // Last counter written to the file
+    uint32_t saved_counter;
     uint8_t original_button;
+    uint8_t current_button;
     FuriString *protocol_name;
+    // In-memory copy of the capture, Btn and Cnt are written back after each press
     FlipperFormat *flipper_format;
+    // flipper_format is the file itself, updates already land on SD
+    bool file_backed;
     SubGhzTransmitter *transmitter;
     bool is_transmitting;
 } EmulateContext;
@@ -91,6 +97,7 @@ static bool protopirate_emulate_update_data(EmulateContext *ctx, uint8_t button)
     flipper_format_rewind(ctx->flipper_format);
 
     // Update button
+    ctx->current_button = button;
     uint32_t btn_value = button;
     if (!flipper_format_update_uint32(ctx->flipper_format, "Btn", &btn_value, 1))
     {
@@ -107,6 +114,43 @@ static bool protopirate_emulate_update_data(EmulateContext *ctx, uint8_t button)
     return true;
 }
 
+// Persists the last button and advanced counter right away, so the next
+// session doesn't replay codes the receiver has already seen even if this
+// one never exits cleanly
+static void protopirate_emulate_write_back(ProtoPirateApp *app, EmulateContext *ctx)
+{
+    if (!app->loaded_file_path || ctx->current_counter == ctx->saved_counter)
+        return;
+
+    uint32_t btn_value = ctx->current_button;
+    bool result = true;
+    if (!ctx->file_backed)
+    {
+        FlipperFormat *ff =
+            protopirate_storage_load_file(furi_string_get_cstr(app->loaded_file_path));
+        if (!ff)
+            return;
+
+        result = flipper_format_insert_or_update_uint32(ff, "Btn", &btn_value, 1);
+        flipper_format_rewind(ff);
+        result &= flipper_format_insert_or_update_uint32(ff, "Cnt", &ctx->current_counter, 1);
+        flipper_format_free(ff);
+    }
+    if (result)
+    {
+        ctx->saved_counter = ctx->current_counter;
+        protopirate_storage_update_counter(
+            furi_string_get_cstr(app->loaded_file_path), btn_value, ctx->current_counter);
+    }
+    else
+    {
+        FURI_LOG_E(TAG, "Failed to write back counter");
+    }
+
+    // The mtime may not have moved within the FAT resolution
+    protopirate_capture_reset(app->capture);
+}
+
 static void protopirate_emulate_draw_callback(Canvas *canvas, void *context)
 {
     UNUSED(context);
@@ -241,38 +285,46 @@ void protopirate_scene_emulate_on_enter(void *context)
     // Load the file
     if (app->loaded_file_path)
     {
-        FlipperFormat *ff = protopirate_storage_load_file(
-            furi_string_get_cstr(app->loaded_file_path));
+        // Usually still cached from the saved info scene
+        const ProtoPirateCaptureInfo *capture = protopirate_capture_load(
+            app->capture, furi_string_get_cstr(app->loaded_file_path));
+        FlipperFormat *ff =
+            capture ? protopirate_capture_get_flipper_format(app->capture) : NULL;
 
         if (ff)
         {
             emulate_context->flipper_format = ff;
+            emulate_context->file_backed = protopirate_capture_is_streamed(app->capture);
 
-            // Read protocol name
-            flipper_format_rewind(ff);
-            if(!flipper_format_read_string(ff, "Protocol", emulate_context->protocol_name)) {
+            if (capture->fields & ProtoPirateCaptureFieldProtocol)
+            {
+                furi_string_set(emulate_context->protocol_name, capture->protocol);
+            }
+            else
+            {
                 FURI_LOG_E(TAG, "Failed to read protocol name");
             }
 
-            // Read serial
-            flipper_format_rewind(ff);
-            if(!flipper_format_read_uint32(ff, "Serial", &emulate_context->serial, 1)) {
+            if (capture->fields & ProtoPirateCaptureFieldSerial)
+            {
+                emulate_context->serial = capture->serial;
+            }
+            else
+            {
                 FURI_LOG_W(TAG, "Failed to read serial");
             }
 
-            // Read original button
-            flipper_format_rewind(ff);
-            uint32_t btn_temp;
-            if (flipper_format_read_uint32(ff, "Btn", &btn_temp, 1))
+            if (capture->fields & ProtoPirateCaptureFieldBtn)
             {
-                emulate_context->original_button = (uint8_t)btn_temp;
+                emulate_context->original_button = (uint8_t)capture->btn;
             }
+            emulate_context->current_button = emulate_context->original_button;
 
-            // Read counter
-            flipper_format_rewind(ff);
-            if (flipper_format_read_uint32(ff, "Cnt", &emulate_context->original_counter, 1))
+            if (capture->fields & ProtoPirateCaptureFieldCnt)
             {
-                emulate_context->current_counter = emulate_context->original_counter;
+                emulate_context->original_counter = capture->cnt;
+                emulate_context->current_counter = capture->cnt;
+                emulate_context->saved_counter = capture->cnt;
             }
 
             // Set up transmitter based on protocol
@@ -477,6 +529,9 @@ bool protopirate_scene_emulate_on_event(void *context, SceneManagerEvent event)
                 }
                 
                 furi_string_free(preset_str);
+
+                // The counter is spent once the press got this far
+                protopirate_emulate_write_back(app, emulate_context);
             }
             else
             {
@@ -539,6 +594,8 @@ void protopirate_scene_emulate_on_exit(void *context)
     // Clean up
     if (emulate_context)
     {
+        // Catches a press whose transmit bailed out early
+        protopirate_emulate_write_back(app, emulate_context);
         if (emulate_context->transmitter)
         {
             subghz_transmitter_free(emulate_context->transmitter);
@@ -1,9 +1,10 @@
 // scenes/protopirate_scene_receiver.c
 #include "../protopirate_app_i.h"
 #include <notification/notification_messages.h>
+#include "../protocols/protocol_items.h"
+#include "../helpers/protopirate_storage.h"
 
-#define TAG                     "ProtoPirateSceneRx"
-#define KIA_DISPLAY_HISTORY_MAX 50
+#define TAG "ProtoPirateSceneRx"
 
 // Forward declaration
 void protopirate_scene_receiver_view_callback(ProtoPirateCustomEvent event, void* context);
@@ -14,13 +15,16 @@ static void protopirate_scene_receiver_update_statusbar(void* context) {
     FuriString* modulation_str = furi_string_alloc();
     FuriString* history_stat_str = furi_string_alloc();
 
+    // Hops rewrite the preset from the timer thread
+    furi_check(furi_mutex_acquire(app->txrx->hopper_mutex, FuriWaitForever) == FuriStatusOk);
     protopirate_get_frequency_modulation(app, frequency_str, modulation_str);
+    furi_check(furi_mutex_release(app->txrx->hopper_mutex) == FuriStatusOk);
 
     furi_string_printf(
         history_stat_str,
         "%u/%u",
         protopirate_history_get_item(app->txrx->history),
-        KIA_DISPLAY_HISTORY_MAX);
+        protopirate_history_get_capacity(app->txrx->history));
 
     protopirate_view_receiver_add_data_statusbar(
         app->protopirate_receiver,
@@ -34,6 +38,49 @@ static void protopirate_scene_receiver_update_statusbar(void* context) {
     furi_string_free(history_stat_str);
 }
 
+static void protopirate_scene_receiver_update_jitter(ProtoPirateApp* app) {
+    ProtoPirateHopperJitter jitter;
+    furi_check(furi_mutex_acquire(app->txrx->hopper_mutex, FuriWaitForever) == FuriStatusOk);
+    protopirate_hopper_get_jitter(app->txrx->hopper, &jitter);
+    furi_check(furi_mutex_release(app->txrx->hopper_mutex) == FuriStatusOk);
+
+    // Mean/max in ms with one decimal
+    FuriString* jitter_str = furi_string_alloc_printf(
+        "Jit %lu.%lu/%lu.%lums",
+        jitter.mean / 1000,
+        jitter.mean / 100 % 10,
+        jitter.max / 1000,
+        jitter.max / 100 % 10);
+    protopirate_view_receiver_set_hopper_stat(
+        app->protopirate_receiver, furi_string_get_cstr(jitter_str));
+    furi_string_free(jitter_str);
+}
+
+// Fixed frequency RX tracks its own floor, hopping shows the current channel's
+static void protopirate_scene_receiver_update_noise_floor(ProtoPirateApp* app, float rssi) {
+    ProtoPirateNoiseFloor noise = app->txrx->noise_floor;
+
+    if(app->txrx->hopper_state == ProtoPirateHopperStateOFF) {
+        protopirate_noise_floor_add(&app->txrx->noise_floor, rssi);
+        noise = app->txrx->noise_floor;
+    } else {
+        furi_check(
+            furi_mutex_acquire(app->txrx->hopper_mutex, FuriWaitForever) == FuriStatusOk);
+        const ProtoPirateNoiseFloor* channel = protopirate_hopper_get_noise(app->txrx->hopper);
+        if(channel) {
+            noise = *channel;
+        }
+        furi_check(furi_mutex_release(app->txrx->hopper_mutex) == FuriStatusOk);
+    }
+
+    protopirate_view_receiver_set_noise_floor(
+        app->protopirate_receiver,
+        noise.level,
+        protopirate_noise_floor_get_threshold(&noise),
+        protopirate_noise_floor_is_valid(&noise));
+}
+
+// Runs in the SubGhz worker context: copy the decoder and hand it to the GUI thread
 static void protopirate_scene_receiver_callback(
     SubGhzReceiver* receiver,
     SubGhzProtocolDecoderBase* decoder_base,
@@ -42,42 +89,96 @@ static void protopirate_scene_receiver_callback(
     furi_assert(context);
     ProtoPirateApp* app = context;
 
-    FURI_LOG_I(TAG, "=== SIGNAL DECODED ===");
+    const ProtoPirateDecoderExt* ext = protopirate_protocol_ext_find(decoder_base->protocol);
+    if(!ext) {
+        return;
+    }
 
-    FuriString* str_buff = furi_string_alloc();
-    subghz_protocol_decoder_base_get_string(decoder_base, str_buff);
-    FURI_LOG_I(TAG, "%s", furi_string_get_cstr(str_buff));
+    // The hopper thread may retune meanwhile, take both from one snapshot
+    uint32_t frequency;
+    uint8_t preset;
+    protopirate_rx_get_tuning(app, &frequency, &preset);
+    // Taken now, the ring may be drained after a hop to another channel
+    float rssi = protopirate_get_rssi(app);
+    if(protopirate_frame_ring_push(
+           app->txrx->frame_ring,
+           decoder_base,
+           ext->decoder_size,
+           frequency,
+           preset,
+           rssi,
+           furi_hal_rtc_get_timestamp())) {
+        view_dispatcher_send_custom_event(
+            app->view_dispatcher, ProtoPirateCustomEventSceneReceiverUpdate);
+    }
+}
 
-    // Add to history
-    if(protopirate_history_add_to_history(app->txrx->history, decoder_base, app->txrx->preset)) {
-        notification_message(app->notifications, &sequence_semi_success);
+static void protopirate_scene_receiver_process_frames(ProtoPirateApp* app) {
+    ProtoPirateFrame* frame;
+    // The frame's own preset, RX may have hopped to another one since
+    SubGhzRadioPreset preset = {.name = furi_string_alloc()};
+
+    while((frame = protopirate_frame_ring_peek(app->txrx->frame_ring))) {
+        SubGhzProtocolDecoderBase* decoder_base = &frame->decoder.base;
+        preset.frequency = frame->frequency;
+        if(frame->preset != PROTOPIRATE_HOPPER_PRESET_CURRENT) {
+            furi_string_set(
+                preset.name, subghz_setting_get_preset_name(app->setting, frame->preset));
+        } else {
+            furi_string_reset(preset.name);
+        }
+        protopirate_hopper_hit(app, frame->frequency, frame->preset);
+
+        FURI_LOG_I(TAG, "Decoded %s", decoder_base->protocol->name);
+
+        // Add to history, text is only rendered once a row is shown
+        uint16_t evicted;
+        if(protopirate_history_add_to_history(
+               app->txrx->history,
+               decoder_base,
+               &preset,
+               frame->rssi,
+               frame->timestamp,
+               &evicted)) {
+            notification_message(app->notifications, &sequence_semi_success);
+
+            if(evicted != PROTOPIRATE_HISTORY_NONE) {
+                protopirate_view_receiver_remove_item_from_menu(
+                    app->protopirate_receiver, evicted);
+            }
 
-        FURI_LOG_I(
-            TAG,
-            "Added to history, total items: %u",
-            protopirate_history_get_item(app->txrx->history));
+            uint16_t idx = protopirate_history_get_item(app->txrx->history) - 1;
+            FURI_LOG_I(TAG, "Added to history, total items: %u", idx + 1);
 
-        FuriString* item_name = furi_string_alloc();
-        protopirate_history_get_text_item_menu(
-            app->txrx->history, item_name, protopirate_history_get_item(app->txrx->history) - 1);
+            protopirate_view_receiver_add_item_to_menu(
+                app->protopirate_receiver,
+                protopirate_history_get_name(app->txrx->history, idx),
+                protopirate_history_get_bits(app->txrx->history, idx),
+                0);
+        } else {
+            FURI_LOG_W(TAG, "Not added to history (repeat or all pinned)");
+        }
 
-        protopirate_view_receiver_add_item_to_menu(
-            app->protopirate_receiver, furi_string_get_cstr(item_name), 0);
+        protopirate_frame_ring_release(app->txrx->frame_ring);
+    }
 
-        furi_string_free(item_name);
+    furi_string_free(preset.name);
+}
 
-        view_dispatcher_send_custom_event(
-            app->view_dispatcher, ProtoPirateCustomEventSceneReceiverUpdate);
-    } else {
-        FURI_LOG_W(TAG, "Failed to add to history (duplicate or full)");
+// Picks up the session left by the last back press, if any
+static void protopirate_scene_receiver_resume(ProtoPirateApp* app) {
+    ProtoPirateHistory* history = app->txrx->history;
+    if(protopirate_history_get_item(history) > 0 ||
+       !protopirate_history_load(history, PROTOPIRATE_HISTORY_SNAPSHOT_PATH)) {
+        return;
     }
 
-    furi_string_free(str_buff);
-
-    // Pause hopper when we receive something
-    if(app->txrx->hopper_state == ProtoPirateHopperStateRunning) {
-        app->txrx->hopper_state = ProtoPirateHopperStatePause;
-        app->txrx->hopper_timeout = 10;
+    for(uint16_t idx = 0; idx < protopirate_history_get_item(history); idx++) {
+        protopirate_view_receiver_add_item_to_menu(
+            app->protopirate_receiver,
+            protopirate_history_get_name(history, idx),
+            protopirate_history_get_bits(history, idx),
+            0);
     }
 }
 
@@ -88,7 +189,10 @@ void protopirate_scene_receiver_on_enter(void* context) {
     FURI_LOG_I(TAG, "Frequency: %lu Hz", app->txrx->preset->frequency);
     FURI_LOG_I(TAG, "Modulation: %s", furi_string_get_cstr(app->txrx->preset->name));
 
-    // Set up the receiver callback
+    protopirate_scene_receiver_resume(app);
+
+    // Set up the receiver callback, frames left from a previous session are stale
+    protopirate_frame_ring_reset(app->txrx->frame_ring);
     subghz_receiver_set_rx_callback(app->txrx->receiver, protopirate_scene_receiver_callback, app);
 
     // Set up view callback
@@ -97,10 +201,19 @@ void protopirate_scene_receiver_on_enter(void* context) {
 
     // Update status bar
     protopirate_scene_receiver_update_statusbar(app);
+    protopirate_view_receiver_set_hopper_stat(app->protopirate_receiver, "");
+
+    // The frequency may have changed in the config, start the floor over
+    protopirate_noise_floor_reset(&app->txrx->noise_floor);
 
-    // Start hopper if enabled
+    // Start hopper if enabled, on the preset of its first channel
     if(app->txrx->hopper_state != ProtoPirateHopperStateOFF) {
         app->txrx->hopper_state = ProtoPirateHopperStateRunning;
+        const ProtoPirateHopperChannel* channel = protopirate_hopper_start(app->txrx->hopper);
+        if(channel) {
+            protopirate_hopper_load_preset(app, channel);
+            app->txrx->preset->frequency = channel->frequency;
+        }
     }
 
     // Get preset data
@@ -116,14 +229,12 @@ void protopirate_scene_receiver_on_enter(void* context) {
     protopirate_begin(app, preset_data);
 
     uint32_t frequency = app->txrx->preset->frequency;
-    if(app->txrx->hopper_state == ProtoPirateHopperStateRunning) {
-        frequency = subghz_setting_get_hopper_frequency(app->setting, 0);
-        app->txrx->hopper_idx_frequency = 0;
-    }
-
     FURI_LOG_I(TAG, "Starting RX on %lu Hz", frequency);
     protopirate_rx(app, frequency);
     FURI_LOG_I(TAG, "RX started, state: %d", app->txrx->txrx_state);
+    if(app->txrx->hopper_state == ProtoPirateHopperStateRunning) {
+        protopirate_hopper_timer_start(app);
+    }
 
     // Switch to receiver view
     view_dispatcher_switch_to_view(app->view_dispatcher, ProtoPirateViewReceiver);
@@ -136,6 +247,7 @@ bool protopirate_scene_receiver_on_event(void* context, SceneManagerEvent event)
     if(event.type == SceneManagerEventTypeCustom) {
         switch(event.event) {
         case ProtoPirateCustomEventSceneReceiverUpdate:
+            protopirate_scene_receiver_process_frames(app);
             protopirate_scene_receiver_update_statusbar(app);
             consumed = true;
             break;
@@ -157,10 +269,15 @@ bool protopirate_scene_receiver_on_event(void* context, SceneManagerEvent event)
             break;
 
         case ProtoPirateCustomEventViewReceiverBack:
+            protopirate_hopper_timer_stop(app);
             if(app->txrx->txrx_state == ProtoPirateTxRxStateRx) {
                 protopirate_rx_end(app);
             }
             protopirate_sleep(app);
+            // Resumed on the next entry, cleared from the receiver config
+            if(protopirate_storage_init()) {
+                protopirate_history_save(app->txrx->history, PROTOPIRATE_HISTORY_SNAPSHOT_PATH);
+            }
             protopirate_history_reset(app->txrx->history);
             scene_manager_search_and_switch_to_previous_scene(
                 app->scene_manager, ProtoPirateSceneStart);
@@ -172,16 +289,17 @@ bool protopirate_scene_receiver_on_event(void* context, SceneManagerEvent event)
             break;
         }
     } else if(event.type == SceneManagerEventTypeTick) {
-        // Update hopper
+        // Hops run on their own thread, only the readouts follow here
         if(app->txrx->hopper_state != ProtoPirateHopperStateOFF) {
-            protopirate_hopper_update(app);
             protopirate_scene_receiver_update_statusbar(app);
+            protopirate_scene_receiver_update_jitter(app);
         }
 
         // Update RSSI
         if(app->txrx->txrx_state == ProtoPirateTxRxStateRx) {
-            float rssi = subghz_devices_get_rssi(app->txrx->radio_device);
+            float rssi = protopirate_get_rssi(app);
             protopirate_view_receiver_set_rssi(app->protopirate_receiver, rssi);
+            protopirate_scene_receiver_update_noise_floor(app, rssi);
         }
 
         consumed = true;
@@ -195,6 +313,7 @@ void protopirate_scene_receiver_on_exit(void* context) {
 
     FURI_LOG_I(TAG, "=== EXITING RECEIVER SCENE ===");
 
+    protopirate_hopper_timer_stop(app);
     if(app->txrx->txrx_state == ProtoPirateTxRxStateRx) {
         protopirate_rx_end(app);
     }
@@ -1,10 +1,17 @@
 // scenes/protopirate_scene_receiver_config.c
 #include "../protopirate_app_i.h"
+#include "../helpers/protopirate_storage.h"
 
 enum ProtoPirateSettingIndex {
     ProtoPirateSettingIndexFrequency,
     ProtoPirateSettingIndexHopping,
+    ProtoPirateSettingIndexHopDwell,
+    ProtoPirateSettingIndexHopModulation,
     ProtoPirateSettingIndexModulation,
+    ProtoPirateSettingIndexSaveTo,
+    ProtoPirateSettingIndexClearHistory,
+    ProtoPirateSettingIndexExportAs,
+    ProtoPirateSettingIndexExportHistory,
     ProtoPirateSettingIndexLock,
 };
 
@@ -18,6 +25,43 @@ const uint32_t hopping_value[HOPPING_COUNT] = {
     ProtoPirateHopperStateRunning,
 };
 
+#define HOP_DWELL_COUNT 5
+const char* const hop_dwell_text[HOP_DWELL_COUNT] = {
+    "20ms",
+    "50ms",
+    "100ms",
+    "200ms",
+    "500ms",
+};
+const uint16_t hop_dwell_value[HOP_DWELL_COUNT] = {
+    20,
+    50,
+    100,
+    200,
+    500,
+};
+
+#define HOP_MODULATION_COUNT 2
+const char* const hop_modulation_text[HOP_MODULATION_COUNT] = {
+    "Preset",
+    "AM+FM",
+};
+const ProtoPirateHopperModulation hop_modulation_value[HOP_MODULATION_COUNT] = {
+    ProtoPirateHopperModulationPreset,
+    ProtoPirateHopperModulationAmFm,
+};
+
+#define SAVE_TO_COUNT 2
+const char* const save_to_text[SAVE_TO_COUNT] = {
+    "Files",
+    "Archive",
+};
+
+const char* const export_as_text[ProtoPirateExportFormatNum] = {
+    "CSV",
+    "JSONL",
+};
+
 uint8_t protopirate_scene_receiver_config_next_frequency(const uint32_t value, void* context) {
     furi_assert(context);
     ProtoPirateApp* app = context;
@@ -135,6 +179,38 @@ static void protopirate_scene_receiver_config_set_hopping_running(VariableItem*
     app->txrx->hopper_state = hopping_value[index];
 }
 
+static void protopirate_scene_receiver_config_set_hop_dwell(VariableItem* item) {
+    ProtoPirateApp* app = variable_item_get_context(item);
+    uint8_t index = variable_item_get_current_value_index(item);
+
+    variable_item_set_current_value_text(item, hop_dwell_text[index]);
+    app->txrx->hopper_dwell = hop_dwell_value[index];
+}
+
+static void protopirate_scene_receiver_config_set_hop_modulation(VariableItem* item) {
+    ProtoPirateApp* app = variable_item_get_context(item);
+    uint8_t index = variable_item_get_current_value_index(item);
+
+    variable_item_set_current_value_text(item, hop_modulation_text[index]);
+    protopirate_hopper_set_modulation(app, hop_modulation_value[index]);
+}
+
+static void protopirate_scene_receiver_config_set_save_to(VariableItem* item) {
+    ProtoPirateApp* app = variable_item_get_context(item);
+    uint8_t index = variable_item_get_current_value_index(item);
+
+    variable_item_set_current_value_text(item, save_to_text[index]);
+    app->save_to_archive = index == 1;
+}
+
+static void protopirate_scene_receiver_config_set_export_as(VariableItem* item) {
+    ProtoPirateApp* app = variable_item_get_context(item);
+    uint8_t index = variable_item_get_current_value_index(item);
+
+    variable_item_set_current_value_text(item, export_as_text[index]);
+    app->export_format = index;
+}
+
 static void
     protopirate_scene_receiver_config_var_list_enter_callback(void* context, uint32_t index) {
     furi_assert(context);
@@ -142,6 +218,12 @@ static void
     if(index == ProtoPirateSettingIndexLock) {
         view_dispatcher_send_custom_event(
             app->view_dispatcher, ProtoPirateCustomEventSceneSettingLock);
+    } else if(index == ProtoPirateSettingIndexClearHistory) {
+        view_dispatcher_send_custom_event(
+            app->view_dispatcher, ProtoPirateCustomEventSceneSettingClearHistory);
+    } else if(index == ProtoPirateSettingIndexExportHistory) {
+        view_dispatcher_send_custom_event(
+            app->view_dispatcher, ProtoPirateCustomEventSceneSettingExportHistory);
     }
 }
 
@@ -181,6 +263,32 @@ void protopirate_scene_receiver_config_on_enter(void* context) {
     variable_item_set_current_value_index(item, value_index);
     variable_item_set_current_value_text(item, hopping_text[value_index]);
 
+    item = variable_item_list_add(
+        app->variable_item_list,
+        "Hop Dwell:",
+        HOP_DWELL_COUNT,
+        protopirate_scene_receiver_config_set_hop_dwell,
+        app);
+    value_index = 0;
+    for(uint8_t i = 0; i < HOP_DWELL_COUNT; i++) {
+        if(hop_dwell_value[i] == app->txrx->hopper_dwell) {
+            value_index = i;
+            break;
+        }
+    }
+    variable_item_set_current_value_index(item, value_index);
+    variable_item_set_current_value_text(item, hop_dwell_text[value_index]);
+
+    item = variable_item_list_add(
+        app->variable_item_list,
+        "Hop Mod:",
+        HOP_MODULATION_COUNT,
+        protopirate_scene_receiver_config_set_hop_modulation,
+        app);
+    value_index = app->txrx->hopper_modulation == ProtoPirateHopperModulationAmFm ? 1 : 0;
+    variable_item_set_current_value_index(item, value_index);
+    variable_item_set_current_value_text(item, hop_modulation_text[value_index]);
+
     item = variable_item_list_add(
         app->variable_item_list,
         "Modulation:",
@@ -193,6 +301,28 @@ void protopirate_scene_receiver_config_on_enter(void* context) {
     variable_item_set_current_value_text(
         item, subghz_setting_get_preset_name(app->setting, value_index));
 
+    item = variable_item_list_add(
+        app->variable_item_list,
+        "Save To:",
+        SAVE_TO_COUNT,
+        protopirate_scene_receiver_config_set_save_to,
+        app);
+    value_index = app->save_to_archive ? 1 : 0;
+    variable_item_set_current_value_index(item, value_index);
+    variable_item_set_current_value_text(item, save_to_text[value_index]);
+
+    variable_item_list_add(app->variable_item_list, "Clear History", 1, NULL, NULL);
+
+    item = variable_item_list_add(
+        app->variable_item_list,
+        "Export As:",
+        ProtoPirateExportFormatNum,
+        protopirate_scene_receiver_config_set_export_as,
+        app);
+    variable_item_set_current_value_index(item, app->export_format);
+    variable_item_set_current_value_text(item, export_as_text[app->export_format]);
+
+    variable_item_list_add(app->variable_item_list, "Export History", 1, NULL, NULL);
     variable_item_list_add(app->variable_item_list, "Lock Keyboard", 1, NULL, NULL);
     variable_item_list_set_enter_callback(
         app->variable_item_list, protopirate_scene_receiver_config_var_list_enter_callback, app);
@@ -209,6 +339,22 @@ bool protopirate_scene_receiver_config_on_event(void* context, SceneManagerEvent
             app->lock = ProtoPirateLockOn;
             scene_manager_previous_scene(app->scene_manager);
             consumed = true;
+        } else if(event.event == ProtoPirateCustomEventSceneSettingClearHistory) {
+            // Drop the snapshot too, or the next receiver entry would resume it
+            protopirate_history_reset(app->txrx->history);
+            protopirate_view_receiver_reset_menu(app->protopirate_receiver);
+            Storage* storage = furi_record_open(RECORD_STORAGE);
+            storage_simply_remove(storage, PROTOPIRATE_HISTORY_SNAPSHOT_PATH);
+            furi_record_close(RECORD_STORAGE);
+            scene_manager_previous_scene(app->scene_manager);
+            consumed = true;
+        } else if(event.event == ProtoPirateCustomEventSceneSettingExportHistory) {
+            if(protopirate_export_history(app->txrx->history, app->export_format, NULL)) {
+                notification_message(app->notifications, &sequence_success);
+            } else {
+                notification_message(app->notifications, &sequence_error);
+            }
+            consumed = true;
         }
     }
     return consumed;
@@ -1,6 +1,5 @@
 // scenes/protopirate_scene_receiver_info.c
 #include "../protopirate_app_i.h"
-#include "../helpers/protopirate_storage.h"
 
 static void protopirate_scene_receiver_info_widget_callback(
     GuiButtonType result,
@@ -15,14 +14,16 @@ static void protopirate_scene_receiver_info_widget_callback(
             view_dispatcher_send_custom_event(
                 app->view_dispatcher, ProtoPirateCustomEventReceiverInfoSave);
         }
+        else if (result == GuiButtonTypeLeft)
+        {
+            view_dispatcher_send_custom_event(
+                app->view_dispatcher, ProtoPirateCustomEventReceiverInfoPin);
+        }
     }
 }
 
-void protopirate_scene_receiver_info_on_enter(void *context)
+static void protopirate_scene_receiver_info_draw(ProtoPirateApp *app)
 {
-    furi_assert(context);
-    ProtoPirateApp *app = context;
-
     FuriString *text;
     text = furi_string_alloc();
 
@@ -45,7 +46,36 @@ void protopirate_scene_receiver_info_on_enter(void *context)
         protopirate_scene_receiver_info_widget_callback,
         app);
 
+    // Pinned entries are never evicted when the history wraps
+    widget_add_button_element(
+        app->widget,
+        GuiButtonTypeLeft,
+        protopirate_history_is_pinned(app->txrx->history, app->txrx->idx_menu_chosen) ? "Unpin"
+                                                                                       : "Pin",
+        protopirate_scene_receiver_info_widget_callback,
+        app);
+
+    // Queue readout: records waiting for the SD card, records dropped because
+    // the save queue was full, decoded frames dropped because the frame ring
+    // was full
+    furi_string_printf(
+        text,
+        "Q%lu D%lu F%lu",
+        protopirate_storage_worker_get_pending(app->storage_worker),
+        protopirate_storage_worker_get_dropped(app->storage_worker),
+        protopirate_frame_ring_get_dropped(app->txrx->frame_ring));
+    widget_add_string_element(
+        app->widget, 64, 63, AlignCenter, AlignBottom, FontSecondary, furi_string_get_cstr(text));
+
     furi_string_free(text);
+}
+
+void protopirate_scene_receiver_info_on_enter(void *context)
+{
+    furi_assert(context);
+    ProtoPirateApp *app = context;
+
+    protopirate_scene_receiver_info_draw(app);
 
     view_dispatcher_switch_to_view(app->view_dispatcher, ProtoPirateViewWidget);
 }
@@ -57,38 +87,42 @@ bool protopirate_scene_receiver_info_on_event(void *context, SceneManagerEvent e
 
     if (event.type == SceneManagerEventTypeCustom)
     {
-        if (event.event == ProtoPirateCustomEventReceiverInfoSave)
+        if (event.event == ProtoPirateCustomEventReceiverInfoPin)
+        {
+            uint16_t idx = app->txrx->idx_menu_chosen;
+            protopirate_history_set_pinned(
+                app->txrx->history, idx, !protopirate_history_is_pinned(app->txrx->history, idx));
+
+            widget_reset(app->widget);
+            protopirate_scene_receiver_info_draw(app);
+            consumed = true;
+        }
+        else if (event.event == ProtoPirateCustomEventReceiverInfoSave)
         {
-            // Get the flipper format from history
+            // Serialized here, written by the storage worker
             FlipperFormat *ff = protopirate_history_get_raw_data(
                 app->txrx->history, app->txrx->idx_menu_chosen);
 
-            if (ff)
+            if (!ff || !protopirate_storage_worker_submit(
+                           app->storage_worker,
+                           ff,
+                           app->save_to_archive ? ProtoPirateStorageTargetArchive
+                                                : ProtoPirateStorageTargetFile))
             {
-                // Extract protocol name
-                FuriString *protocol = furi_string_alloc();
-                flipper_format_rewind(ff);
-                if (!flipper_format_read_string(ff, "Protocol", protocol))
-                {
-                    furi_string_set_str(protocol, "Unknown");
-                }
-
-                FuriString *saved_path = furi_string_alloc();
-                if (protopirate_storage_save_capture(
-                        ff, furi_string_get_cstr(protocol), saved_path))
-                {
-
-                    // Show success notification
-                    notification_message(app->notifications, &sequence_success);
-                }
-                else
-                {
-                    notification_message(app->notifications, &sequence_error);
-                }
-
-                furi_string_free(protocol);
-                furi_string_free(saved_path);
+                notification_message(app->notifications, &sequence_error);
             }
+
+            widget_reset(app->widget);
+            protopirate_scene_receiver_info_draw(app);
+            consumed = true;
+        }
+        else if (
+            event.event == ProtoPirateCustomEventStorageSaved ||
+            event.event == ProtoPirateCustomEventStorageFailed)
+        {
+            // The queue readout changed, the app already notified
+            widget_reset(app->widget);
+            protopirate_scene_receiver_info_draw(app);
             consumed = true;
         }
     }
@@ -1,61 +1,188 @@
 // scenes/protopirate_scene_saved.c
 #include "../protopirate_app_i.h"
 #include "../helpers/protopirate_storage.h"
+#include "../protocols/protocol_items.h"
 
+// Only one page of names is resolved into the submenu at a time, so the
+// cost of opening the browser doesn't grow with the number of captures
+#define SAVED_PAGE_SIZE 20
+
+// Submenu indices below SAVED_PAGE_SIZE are positions within the page
 typedef enum
 {
     SubmenuIndexBack = 0xFF,
+    SubmenuIndexSort = 0x100,
+    SubmenuIndexFilter,
+    SubmenuIndexExport,
+    SubmenuIndexUnpack,
+    SubmenuIndexPack,
+    SubmenuIndexPrev,
+    SubmenuIndexNext,
 } SavedMenuIndex;
 
+// Scene state: page << 16 | selected submenu index
+#define SAVED_STATE(page, selected) (((page) << 16) | (selected))
+#define SAVED_STATE_PAGE(state) ((state) >> 16)
+#define SAVED_STATE_SELECTED(state) ((state) & 0xFFFF)
+
+static const char *const saved_sort_names[ProtoPirateStorageSortNum] = {
+    "Sort: Name",
+    "Sort: Protocol",
+    "Sort: Newest",
+};
+
 static void protopirate_scene_saved_submenu_callback(void *context, uint32_t index)
 {
     ProtoPirateApp *app = context;
     view_dispatcher_send_custom_event(app->view_dispatcher, index);
 }
 
-void protopirate_scene_saved_on_enter(void *context)
+static void protopirate_scene_saved_build(ProtoPirateApp *app, uint32_t page, uint32_t selected)
 {
-    ProtoPirateApp *app = context;
-
     submenu_reset(app->submenu);
-    submenu_set_header(app->submenu, "Saved Captures");
 
     uint32_t file_count = protopirate_storage_get_file_count();
+    ProtoPirateStorageFilter filter;
+    bool filtered = protopirate_storage_get_filter(&filter);
 
-    if (file_count == 0)
+    if (file_count == 0 && !filtered)
     {
+        submenu_set_header(app->submenu, "Saved Captures");
         submenu_add_item(
             app->submenu,
             "No saved captures",
             SubmenuIndexBack,
             protopirate_scene_saved_submenu_callback,
             app);
+        // Archived sessions may still hold captures
+        submenu_add_item(
+            app->submenu,
+            "Unpack archives",
+            SubmenuIndexUnpack,
+            protopirate_scene_saved_submenu_callback,
+            app);
+        submenu_set_selected_item(app->submenu, selected);
+        scene_manager_set_scene_state(
+            app->scene_manager, ProtoPirateSceneSaved, SAVED_STATE(0, selected));
+        view_dispatcher_switch_to_view(app->view_dispatcher, ProtoPirateViewSubmenu);
+        return;
+    }
+
+    // A delete may have emptied the last page
+    uint32_t page_count = (file_count + SAVED_PAGE_SIZE - 1) / SAVED_PAGE_SIZE;
+    if (page >= page_count)
+    {
+        page = page_count ? page_count - 1 : 0;
+    }
+    uint32_t first = page * SAVED_PAGE_SIZE;
+    uint32_t last = MIN(first + SAVED_PAGE_SIZE, file_count);
+
+    FuriString *name = furi_string_alloc();
+    FuriString *path = furi_string_alloc();
+
+    furi_string_printf(name, "Saved %lu-%lu/%lu", MIN(first + 1, last), last, file_count);
+    submenu_set_header(app->submenu, furi_string_get_cstr(name));
+
+    submenu_add_item(
+        app->submenu,
+        saved_sort_names[protopirate_storage_get_sort()],
+        SubmenuIndexSort,
+        protopirate_scene_saved_submenu_callback,
+        app);
+
+    if (!filtered)
+    {
+        furi_string_set_str(path, "Filter: All");
+    }
+    else if (filter.fields & ProtoPirateCaptureFieldSerial)
+    {
+        furi_string_printf(path, "Filter: SN %08lX", filter.serial);
     }
     else
     {
-        FuriString *name = furi_string_alloc();
-        FuriString *path = furi_string_alloc();
+        furi_string_printf(
+            path, "Filter: %s", protopirate_protocol_registry.items[filter.protocol]->name);
+    }
+    submenu_add_item(
+        app->submenu,
+        furi_string_get_cstr(path),
+        SubmenuIndexFilter,
+        protopirate_scene_saved_submenu_callback,
+        app);
+
+    submenu_add_item(
+        app->submenu,
+        app->export_format == ProtoPirateExportFormatJsonl ? "Export list (JSONL)" :
+                                                             "Export list (CSV)",
+        SubmenuIndexExport,
+        protopirate_scene_saved_submenu_callback,
+        app);
+
+    submenu_add_item(
+        app->submenu,
+        "Unpack archives",
+        SubmenuIndexUnpack,
+        protopirate_scene_saved_submenu_callback,
+        app);
+
+    // Exactly what is listed, like the export
+    submenu_add_item(
+        app->submenu,
+        "Pack list to archive",
+        SubmenuIndexPack,
+        protopirate_scene_saved_submenu_callback,
+        app);
 
-        for (uint32_t i = 0; i < file_count && i < 50; i++)
+    if (page > 0)
+    {
+        submenu_add_item(
+            app->submenu,
+            "< Previous page",
+            SubmenuIndexPrev,
+            protopirate_scene_saved_submenu_callback,
+            app);
+    }
+
+    for (uint32_t i = first; i < last; i++)
+    {
+        if (protopirate_storage_get_file_by_index(i, path, name))
         {
-            if (protopirate_storage_get_file_by_index(i, path, name))
-            {
-                submenu_add_item(
-                    app->submenu,
-                    furi_string_get_cstr(name),
-                    i,
-                    protopirate_scene_saved_submenu_callback,
-                    app);
-            }
+            submenu_add_item(
+                app->submenu,
+                furi_string_get_cstr(name),
+                i - first,
+                protopirate_scene_saved_submenu_callback,
+                app);
         }
+    }
 
-        furi_string_free(name);
-        furi_string_free(path);
+    if (last < file_count)
+    {
+        submenu_add_item(
+            app->submenu,
+            "Next page >",
+            SubmenuIndexNext,
+            protopirate_scene_saved_submenu_callback,
+            app);
     }
 
+    furi_string_free(name);
+    furi_string_free(path);
+
+    submenu_set_selected_item(app->submenu, selected);
+    scene_manager_set_scene_state(
+        app->scene_manager, ProtoPirateSceneSaved, SAVED_STATE(page, selected));
     view_dispatcher_switch_to_view(app->view_dispatcher, ProtoPirateViewSubmenu);
 }
 
+void protopirate_scene_saved_on_enter(void *context)
+{
+    ProtoPirateApp *app = context;
+
+    uint32_t state = scene_manager_get_scene_state(app->scene_manager, ProtoPirateSceneSaved);
+    protopirate_scene_saved_build(app, SAVED_STATE_PAGE(state), SAVED_STATE_SELECTED(state));
+}
+
 bool protopirate_scene_saved_on_event(void *context, SceneManagerEvent event)
 {
     ProtoPirateApp *app = context;
@@ -63,18 +190,80 @@ bool protopirate_scene_saved_on_event(void *context, SceneManagerEvent event)
 
     if (event.type == SceneManagerEventTypeCustom)
     {
+        uint32_t page = SAVED_STATE_PAGE(
+            scene_manager_get_scene_state(app->scene_manager, ProtoPirateSceneSaved));
+
         if (event.event == SubmenuIndexBack)
         {
             // Just go back
             consumed = true;
         }
-        else
+        else if (event.event == SubmenuIndexSort)
+        {
+            protopirate_storage_set_sort(
+                (ProtoPirateStorageSort)((protopirate_storage_get_sort() + 1) %
+                                         ProtoPirateStorageSortNum));
+            protopirate_scene_saved_build(app, 0, SubmenuIndexSort);
+            consumed = true;
+        }
+        else if (event.event == SubmenuIndexFilter)
+        {
+            scene_manager_set_scene_state(
+                app->scene_manager, ProtoPirateSceneSaved, SAVED_STATE(page, SubmenuIndexFilter));
+            scene_manager_next_scene(app->scene_manager, ProtoPirateSceneSavedFilter);
+            consumed = true;
+        }
+        else if (event.event == SubmenuIndexExport)
+        {
+            // Exactly what is listed, in the current sort and filter
+            if (protopirate_export_saved(app->export_format, NULL))
+            {
+                notification_message(app->notifications, &sequence_success);
+            }
+            else
+            {
+                notification_message(app->notifications, &sequence_error);
+            }
+            // The export file is not a capture, the listing is unchanged
+            consumed = true;
+        }
+        else if (event.event == SubmenuIndexUnpack || event.event == SubmenuIndexPack)
+        {
+            // Runs on the storage worker, the listing is rebuilt once it is done
+            if (!protopirate_storage_worker_run(
+                    app->storage_worker,
+                    event.event == SubmenuIndexUnpack ? ProtoPirateStorageTargetUnpack
+                                                      : ProtoPirateStorageTargetPack))
+            {
+                notification_message(app->notifications, &sequence_error);
+            }
+            consumed = true;
+        }
+        else if (
+            event.event == ProtoPirateCustomEventStorageArchived ||
+            event.event == ProtoPirateCustomEventStorageArchiveFailed)
+        {
+            // Archive records became captures of their own, or the reverse
+            protopirate_scene_saved_build(app, 0, 0);
+            consumed = true;
+        }
+        else if (event.event == SubmenuIndexPrev)
+        {
+            protopirate_scene_saved_build(app, page - 1, 0);
+            consumed = true;
+        }
+        else if (event.event == SubmenuIndexNext)
+        {
+            protopirate_scene_saved_build(app, page + 1, 0);
+            consumed = true;
+        }
+        else if (event.event < SAVED_PAGE_SIZE)
         {
             // Load and display the selected file
             FuriString *path = furi_string_alloc();
-            FuriString *name = furi_string_alloc();
 
-            if (protopirate_storage_get_file_by_index(event.event, path, name))
+            if (protopirate_storage_get_file_by_index(
+                    page * SAVED_PAGE_SIZE + event.event, path, NULL))
             {
                 // Store path for the info scene to use
                 if (app->loaded_file_path)
@@ -83,11 +272,12 @@ bool protopirate_scene_saved_on_event(void *context, SceneManagerEvent event)
                 }
                 app->loaded_file_path = furi_string_alloc_set(path);
 
+                scene_manager_set_scene_state(
+                    app->scene_manager, ProtoPirateSceneSaved, SAVED_STATE(page, event.event));
                 scene_manager_next_scene(app->scene_manager, ProtoPirateSceneSavedInfo);
             }
 
             furi_string_free(path);
-            furi_string_free(name);
             consumed = true;
         }
     }
@@ -99,4 +289,4 @@ void protopirate_scene_saved_on_exit(void *context)
 {
     ProtoPirateApp *app = context;
     submenu_reset(app->submenu);
-}
\ No newline at end of file
+}
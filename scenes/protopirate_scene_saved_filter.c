@@ -0,0 +1,103 @@
+// scenes/protopirate_scene_saved_filter.c
+#include "../protopirate_app_i.h"
+#include "../helpers/protopirate_storage.h"
+#include "../protocols/protocol_items.h"
+
+// Submenu indices below the registry size select a protocol
+typedef enum
+{
+    SubmenuIndexAll = 0x100,
+} SavedFilterMenuIndex;
+
+static void protopirate_scene_saved_filter_submenu_callback(void *context, uint32_t index)
+{
+    ProtoPirateApp *app = context;
+    view_dispatcher_send_custom_event(app->view_dispatcher, index);
+}
+
+void protopirate_scene_saved_filter_on_enter(void *context)
+{
+    ProtoPirateApp *app = context;
+
+    submenu_reset(app->submenu);
+    submenu_set_header(app->submenu, "Filter Captures");
+
+    submenu_add_item(
+        app->submenu,
+        "Show all",
+        SubmenuIndexAll,
+        protopirate_scene_saved_filter_submenu_callback,
+        app);
+
+    // Only protocols with saved captures are offered, counted from the index
+    uint32_t *counts = malloc(sizeof(uint32_t) * protopirate_protocol_registry.size);
+    protopirate_storage_count_protocols(counts);
+
+    ProtoPirateStorageFilter filter;
+    uint32_t selected = SubmenuIndexAll;
+    if (protopirate_storage_get_filter(&filter) &&
+        filter.fields == ProtoPirateCaptureFieldProtocol)
+    {
+        selected = filter.protocol;
+    }
+
+    FuriString *label = furi_string_alloc();
+    for (size_t i = 0; i < protopirate_protocol_registry.size; i++)
+    {
+        if (counts[i] == 0)
+            continue;
+
+        furi_string_printf(
+            label, "%s (%lu)", protopirate_protocol_registry.items[i]->name, counts[i]);
+        submenu_add_item(
+            app->submenu,
+            furi_string_get_cstr(label),
+            i,
+            protopirate_scene_saved_filter_submenu_callback,
+            app);
+    }
+    furi_string_free(label);
+    free(counts);
+
+    submenu_set_selected_item(app->submenu, selected);
+    view_dispatcher_switch_to_view(app->view_dispatcher, ProtoPirateViewSubmenu);
+}
+
+bool protopirate_scene_saved_filter_on_event(void *context, SceneManagerEvent event)
+{
+    ProtoPirateApp *app = context;
+    bool consumed = false;
+
+    if (event.type == SceneManagerEventTypeCustom)
+    {
+        if (event.event == SubmenuIndexAll)
+        {
+            protopirate_storage_set_filter(NULL);
+            consumed = true;
+        }
+        else if (event.event < protopirate_protocol_registry.size)
+        {
+            ProtoPirateStorageFilter filter = {
+                .fields = ProtoPirateCaptureFieldProtocol,
+                .protocol = event.event,
+            };
+            protopirate_storage_set_filter(&filter);
+            consumed = true;
+        }
+
+        if (consumed)
+        {
+            // Start the filtered listing from its first page
+            scene_manager_set_scene_state(app->scene_manager, ProtoPirateSceneSaved, 0);
+            scene_manager_previous_scene(app->scene_manager);
+        }
+    }
+
+    return consumed;
+}
+
+void protopirate_scene_saved_filter_on_exit(void *context)
+{
+    ProtoPirateApp *app = context;
+    submenu_reset(app->submenu);
+}
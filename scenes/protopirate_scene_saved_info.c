@@ -20,6 +20,11 @@ static void protopirate_scene_saved_info_widget_callback(
             view_dispatcher_send_custom_event(
                 app->view_dispatcher, ProtoPirateCustomEventSavedInfoDelete);
         }
+        else if (result == GuiButtonTypeCenter)
+        { // Same serial button
+            view_dispatcher_send_custom_event(
+                app->view_dispatcher, ProtoPirateCustomEventSavedInfoSameSerial);
+        }
     }
 }
 
@@ -29,90 +34,92 @@ void protopirate_scene_saved_info_on_enter(void *context)
 
     widget_reset(app->widget);
 
+    const ProtoPirateCaptureInfo *capture = NULL;
     if (app->loaded_file_path)
     {
-        FlipperFormat *ff = protopirate_storage_load_file(
-            furi_string_get_cstr(app->loaded_file_path));
-
-        if (ff)
-        {
-            FuriString *info_str = furi_string_alloc();
-            FuriString *temp_str = furi_string_alloc();
-            uint32_t temp_data;
-
-            // Protocol
-            if (flipper_format_read_string(ff, "Protocol", temp_str))
-            {
-                furi_string_cat_printf(info_str, "Protocol: %s\n", furi_string_get_cstr(temp_str));
-            }
+        capture = protopirate_capture_load(app->capture, furi_string_get_cstr(app->loaded_file_path));
+    }
 
-            // Frequency
-            flipper_format_rewind(ff);
-            if (flipper_format_read_uint32(ff, "Frequency", &temp_data, 1))
-            {
-                furi_string_cat_printf(
-                    info_str, "Freq: %lu.%02lu MHz\n",
-                    temp_data / 1000000, (temp_data % 1000000) / 10000);
-            }
+    if (capture)
+    {
+        FuriString *info_str = furi_string_alloc();
 
-            // Serial
-            flipper_format_rewind(ff);
-            if (flipper_format_read_uint32(ff, "Serial", &temp_data, 1))
-            {
-                furi_string_cat_printf(info_str, "Serial: %08lX\n", temp_data);
-            }
+        // Protocol
+        if (capture->fields & ProtoPirateCaptureFieldProtocol)
+        {
+            furi_string_cat_printf(
+                info_str, "Protocol: %s\n", furi_string_get_cstr(capture->protocol));
+        }
 
-            // Button
-            flipper_format_rewind(ff);
-            if (flipper_format_read_uint32(ff, "Btn", &temp_data, 1))
-            {
-                furi_string_cat_printf(info_str, "Button: %02X\n", (uint8_t)temp_data);
-            }
+        // Frequency
+        if (capture->fields & ProtoPirateCaptureFieldFrequency)
+        {
+            furi_string_cat_printf(
+                info_str, "Freq: %lu.%02lu MHz\n",
+                capture->frequency / 1000000, (capture->frequency % 1000000) / 10000);
+        }
 
-            // Counter
-            flipper_format_rewind(ff);
-            if (flipper_format_read_uint32(ff, "Cnt", &temp_data, 1))
-            {
-                furi_string_cat_printf(info_str, "Counter: %04lX\n", temp_data);
-            }
+        // Serial
+        if (capture->fields & ProtoPirateCaptureFieldSerial)
+        {
+            furi_string_cat_printf(info_str, "Serial: %08lX\n", capture->serial);
+        }
 
-            // Protocol-specific fields
-            flipper_format_rewind(ff);
-            if (flipper_format_read_uint32(ff, "CRC", &temp_data, 1))
-            {
-                furi_string_cat_printf(info_str, "CRC: %02X\n", (uint8_t)temp_data);
-            }
+        // Button
+        if (capture->fields & ProtoPirateCaptureFieldBtn)
+        {
+            furi_string_cat_printf(info_str, "Button: %02X\n", (uint8_t)capture->btn);
+        }
 
-            flipper_format_rewind(ff);
-            if (flipper_format_read_uint32(ff, "Type", &temp_data, 1))
-            {
-                furi_string_cat_printf(info_str, "Type: %02X\n", (uint8_t)temp_data);
-            }
+        // Counter
+        if (capture->fields & ProtoPirateCaptureFieldCnt)
+        {
+            furi_string_cat_printf(info_str, "Counter: %04lX\n", capture->cnt);
+        }
 
-            // Add text to the widget
-            widget_add_text_scroll_element(
-                app->widget, 0, 0, 128, 50,
-                furi_string_get_cstr(info_str));
+        // Protocol-specific fields
+        if (capture->fields & ProtoPirateCaptureFieldCrc)
+        {
+            furi_string_cat_printf(info_str, "CRC: %02X\n", (uint8_t)capture->crc);
+        }
 
-            // Add buttons
-            widget_add_button_element(
-                app->widget,
-                GuiButtonTypeLeft,
-                "Emulate",
-                protopirate_scene_saved_info_widget_callback,
-                app);
+        if (capture->fields & ProtoPirateCaptureFieldType)
+        {
+            furi_string_cat_printf(info_str, "Type: %02X\n", (uint8_t)capture->type);
+        }
 
+        // Add text to the widget
+        widget_add_text_scroll_element(
+            app->widget, 0, 0, 128, 50,
+            furi_string_get_cstr(info_str));
+
+        // Add buttons
+        widget_add_button_element(
+            app->widget,
+            GuiButtonTypeLeft,
+            "Emulate",
+            protopirate_scene_saved_info_widget_callback,
+            app);
+
+        widget_add_button_element(
+            app->widget,
+            GuiButtonTypeRight,
+            "Delete",
+            protopirate_scene_saved_info_widget_callback,
+            app);
+
+        // Lists every saved capture of this fob
+        if (capture->fields & ProtoPirateCaptureFieldSerial)
+        {
             widget_add_button_element(
                 app->widget,
-                GuiButtonTypeRight,
-                "Delete",
+                GuiButtonTypeCenter,
+                "Same SN",
                 protopirate_scene_saved_info_widget_callback,
                 app);
-
-            furi_string_free(temp_str);
-            furi_string_free(info_str);
-            flipper_format_free(ff);
         }
+
+        furi_string_free(info_str);
     }
 
     view_dispatcher_switch_to_view(app->view_dispatcher, ProtoPirateViewWidget);
@@ -130,6 +137,28 @@ bool protopirate_scene_saved_info_on_event(void *context, SceneManagerEvent even
             if (app->loaded_file_path)
             {
                 protopirate_storage_delete_file(furi_string_get_cstr(app->loaded_file_path));
+                protopirate_capture_reset(app->capture);
+                scene_manager_previous_scene(app->scene_manager);
+            }
+            consumed = true;
+        }
+
+        if (event.event == ProtoPirateCustomEventSavedInfoSameSerial)
+        {
+            const ProtoPirateCaptureInfo *capture = NULL;
+            if (app->loaded_file_path)
+            {
+                capture = protopirate_capture_load(
+                    app->capture, furi_string_get_cstr(app->loaded_file_path));
+            }
+            if (capture && (capture->fields & ProtoPirateCaptureFieldSerial))
+            {
+                ProtoPirateStorageFilter filter = {
+                    .fields = ProtoPirateCaptureFieldSerial,
+                    .serial = capture->serial,
+                };
+                protopirate_storage_set_filter(&filter);
+                scene_manager_set_scene_state(app->scene_manager, ProtoPirateSceneSaved, 0);
                 scene_manager_previous_scene(app->scene_manager);
             }
             consumed = true;
@@ -10,12 +10,24 @@
 #define MAX_LEN_PX   112
 #define MENU_ITEMS   4u
 #define UNLOCK_CNT   3
+#define CACHE_LINES  (MENU_ITEMS * 2)
 
+// Rows keep only the fields the menu line is built from
 typedef struct {
-    FuriString* item_str;
+    const char* name;
+    uint32_t uid; // Stable across removals, keys the line cache
+    uint16_t bits;
     uint8_t type;
 } ProtoPirateReceiverMenuItem;
 
+// Rendered and width-fitted menu line, uid 0 marks a free entry
+typedef struct {
+    FuriString* text;
+    uint32_t uid;
+    uint32_t last_used;
+    bool scrollbar;
+} ProtoPirateReceiverLine;
+
 ARRAY_DEF(ProtoPirateReceiverMenuItemArray, ProtoPirateReceiverMenuItem, M_POD_OPLIST)
 
 struct ProtoPirateReceiver {
@@ -26,12 +38,19 @@ struct ProtoPirateReceiver {
 
 typedef struct {
     ProtoPirateReceiverMenuItemArray_t history_item_arr;
-    uint8_t list_offset;
-    uint8_t history_item;
+    uint16_t list_offset;
+    uint16_t history_item;
+    uint32_t next_uid;
+    ProtoPirateReceiverLine lines[CACHE_LINES];
+    uint32_t lines_tick;
     float rssi;
+    float noise_floor;
+    float rssi_threshold;
+    bool noise_floor_valid;
     FuriString* frequency_str;
     FuriString* preset_str;
     FuriString* history_stat_str;
+    FuriString* hopper_stat_str;
     bool external_radio;
     ProtoPirateLock lock;
     uint8_t lock_count;
@@ -44,6 +63,32 @@ void protopirate_view_receiver_set_rssi(ProtoPirateReceiver* receiver, float rss
         receiver->view, ProtoPirateReceiverModel * model, { model->rssi = rssi; }, true);
 }
 
+void protopirate_view_receiver_set_noise_floor(
+    ProtoPirateReceiver* receiver,
+    float level,
+    float threshold,
+    bool valid) {
+    furi_assert(receiver);
+    with_view_model(
+        receiver->view,
+        ProtoPirateReceiverModel * model,
+        {
+            model->noise_floor = level;
+            model->rssi_threshold = threshold;
+            model->noise_floor_valid = valid;
+        },
+        true);
+}
+
+void protopirate_view_receiver_set_hopper_stat(ProtoPirateReceiver* receiver, const char* stat) {
+    furi_assert(receiver);
+    with_view_model(
+        receiver->view,
+        ProtoPirateReceiverModel * model,
+        { furi_string_set_str(model->hopper_stat_str, stat); },
+        true);
+}
+
 void protopirate_view_receiver_set_lock(ProtoPirateReceiver* receiver, ProtoPirateLock lock) {
     furi_assert(receiver);
     with_view_model(
@@ -87,6 +132,7 @@ static void protopirate_view_receiver_update_offset(ProtoPirateReceiver* receive
 void protopirate_view_receiver_add_item_to_menu(
     ProtoPirateReceiver* receiver,
     const char* name,
+    uint16_t bits,
     uint8_t type) {
     furi_assert(receiver);
     with_view_model(
@@ -95,13 +141,48 @@ void protopirate_view_receiver_add_item_to_menu(
         {
             ProtoPirateReceiverMenuItem* item_menu =
                 ProtoPirateReceiverMenuItemArray_push_raw(model->history_item_arr);
-            item_menu->item_str = furi_string_alloc_set(name);
+            item_menu->name = name;
+            item_menu->uid = model->next_uid++;
+            item_menu->bits = bits;
             item_menu->type = type;
         },
         true);
     protopirate_view_receiver_update_offset(receiver);
 }
 
+void protopirate_view_receiver_reset_menu(ProtoPirateReceiver* receiver) {
+    furi_assert(receiver);
+    with_view_model(
+        receiver->view,
+        ProtoPirateReceiverModel * model,
+        {
+            ProtoPirateReceiverMenuItemArray_reset(model->history_item_arr);
+            model->history_item = 0;
+            model->list_offset = 0;
+        },
+        true);
+}
+
+void protopirate_view_receiver_remove_item_from_menu(ProtoPirateReceiver* receiver, uint16_t idx) {
+    furi_assert(receiver);
+    with_view_model(
+        receiver->view,
+        ProtoPirateReceiverModel * model,
+        {
+            if(idx < ProtoPirateReceiverMenuItemArray_size(model->history_item_arr)) {
+                // Its cached line, if any, ages out of the cache on its own
+                ProtoPirateReceiverMenuItem item_menu;
+                ProtoPirateReceiverMenuItemArray_pop_at(&item_menu, model->history_item_arr, idx);
+                // Keep the cursor on the same entry as the list shifts up
+                if(model->history_item > idx) {
+                    model->history_item--;
+                }
+            }
+        },
+        true);
+    protopirate_view_receiver_update_offset(receiver);
+}
+
 void protopirate_view_receiver_add_data_statusbar(
     ProtoPirateReceiver* receiver,
     const char* frequency_str,
@@ -135,6 +216,33 @@ static void protopirate_view_receiver_draw_frame(Canvas* canvas, uint16_t idx, b
     canvas_draw_dot(canvas, scrollbar ? 121 : 126, (0 + idx * FRAME_HEIGHT) + 11);
 }
 
+// Lines are rendered only when a row becomes visible, the cache covers scrolling
+static const char* protopirate_view_receiver_get_line(
+    Canvas* canvas,
+    ProtoPirateReceiverModel* model,
+    const ProtoPirateReceiverMenuItem* item,
+    bool scrollbar) {
+    ProtoPirateReceiverLine* line = &model->lines[0];
+    model->lines_tick++;
+
+    for(size_t i = 0; i < CACHE_LINES; i++) {
+        if(model->lines[i].uid == item->uid && model->lines[i].scrollbar == scrollbar) {
+            model->lines[i].last_used = model->lines_tick;
+            return furi_string_get_cstr(model->lines[i].text);
+        }
+        if(model->lines[i].last_used < line->last_used) {
+            line = &model->lines[i];
+        }
+    }
+
+    furi_string_printf(line->text, "%s %ubit", item->name, item->bits);
+    elements_string_fit_width(canvas, line->text, scrollbar ? MAX_LEN_PX - 6 : MAX_LEN_PX);
+    line->uid = item->uid;
+    line->scrollbar = scrollbar;
+    line->last_used = model->lines_tick;
+    return furi_string_get_cstr(line->text);
+}
+
 void protopirate_view_receiver_draw(Canvas* canvas, ProtoPirateReceiverModel* model) {
     canvas_clear(canvas);
     canvas_set_color(canvas, ColorBlack);
@@ -146,9 +254,6 @@ void protopirate_view_receiver_draw(Canvas* canvas, ProtoPirateReceiverModel* mo
     size_t item_count = ProtoPirateReceiverMenuItemArray_size(model->history_item_arr);
     bool scrollbar = item_count > MENU_ITEMS;
 
-    FuriString* str_buff;
-    str_buff = furi_string_alloc();
-
     if(item_count > 0) {
         // Draw received items list
         size_t shift_position = model->list_offset;
@@ -157,9 +262,7 @@ void protopirate_view_receiver_draw(Canvas* canvas, ProtoPirateReceiverModel* mo
             size_t idx = shift_position + i;
             ProtoPirateReceiverMenuItem* item =
                 ProtoPirateReceiverMenuItemArray_get(model->history_item_arr, idx);
-
-            furi_string_set(str_buff, item->item_str);
-            elements_string_fit_width(canvas, str_buff, scrollbar ? MAX_LEN_PX - 6 : MAX_LEN_PX);
+            const char* text = protopirate_view_receiver_get_line(canvas, model, item, scrollbar);
 
             if(model->history_item == idx) {
                 protopirate_view_receiver_draw_frame(canvas, i, scrollbar);
@@ -167,7 +270,7 @@ void protopirate_view_receiver_draw(Canvas* canvas, ProtoPirateReceiverModel* mo
                 canvas_set_color(canvas, ColorBlack);
             }
 
-            canvas_draw_str(canvas, 4, 9 + (i * FRAME_HEIGHT), furi_string_get_cstr(str_buff));
+            canvas_draw_str(canvas, 4, 9 + (i * FRAME_HEIGHT), text);
         }
 
         if(scrollbar) {
@@ -270,10 +373,15 @@ void protopirate_view_receiver_draw(Canvas* canvas, ProtoPirateReceiverModel* mo
         // Left-aligned config hint
         canvas_set_font(canvas, FontSecondary);
         canvas_draw_str(canvas, 2, 45, "< Config");
+        canvas_draw_str_aligned(
+            canvas,
+            126,
+            45,
+            AlignRight,
+            AlignBottom,
+            furi_string_get_cstr(model->hopper_stat_str));
     }
 
-    furi_string_free(str_buff);
-
     // Status bar separator
     canvas_set_color(canvas, ColorBlack);
     canvas_draw_line(canvas, 0, 48, 127, 48);
@@ -281,8 +389,8 @@ void protopirate_view_receiver_draw(Canvas* canvas, ProtoPirateReceiverModel* mo
     // Draw status bar
     canvas_set_font(canvas, FontSecondary);
     
-    // Activity indicator - pulsing when receiving
-    if(model->rssi > -90) {
+    // Activity indicator - pulsing when above the noise gate
+    if(model->rssi > model->rssi_threshold) {
         int pulse = model->animation_frame % 16;
         if(pulse < 8) {
             canvas_draw_disc(canvas, 2, 54, 1);
@@ -299,6 +407,13 @@ void protopirate_view_receiver_draw(Canvas* canvas, ProtoPirateReceiverModel* mo
     canvas_draw_str_aligned(
         canvas, 108, 58, AlignCenter, AlignBottom, furi_string_get_cstr(model->history_stat_str));
 
+    // Noise floor, dBm
+    if(model->noise_floor_valid) {
+        char noise_str[8];
+        snprintf(noise_str, sizeof(noise_str), "%d", (int)model->noise_floor);
+        canvas_draw_str_aligned(canvas, 68, 58, AlignRight, AlignBottom, noise_str);
+    }
+
     // Draw RSSI indicator with animation
     uint8_t x = 70;
     uint8_t y = 51;
@@ -418,22 +533,7 @@ bool protopirate_view_receiver_input(InputEvent* event, void* context) {
             break;
         case InputKeyBack:
             if(receiver->callback) {
-                with_view_model(
-                    receiver->view,
-                    ProtoPirateReceiverModel * model,
-                    {
-                        for(size_t i = 0;
-                            i < ProtoPirateReceiverMenuItemArray_size(model->history_item_arr);
-                            i++) {
-                            ProtoPirateReceiverMenuItem* item =
-                                ProtoPirateReceiverMenuItemArray_get(model->history_item_arr, i);
-                            furi_string_free(item->item_str);
-                        }
-                        ProtoPirateReceiverMenuItemArray_reset(model->history_item_arr);
-                        model->history_item = 0;
-                        model->list_offset = 0;
-                    },
-                    false);
+                protopirate_view_receiver_reset_menu(receiver);
                 receiver->callback(ProtoPirateCustomEventViewReceiverBack, receiver->context);
             }
             consumed = true;
@@ -475,9 +575,21 @@ ProtoPirateReceiver* protopirate_view_receiver_alloc() {
             model->frequency_str = furi_string_alloc();
             model->preset_str = furi_string_alloc();
             model->history_stat_str = furi_string_alloc();
+            model->hopper_stat_str = furi_string_alloc();
             model->list_offset = 0;
             model->history_item = 0;
+            model->next_uid = 1;
+            for(size_t i = 0; i < CACHE_LINES; i++) {
+                model->lines[i].text = furi_string_alloc();
+                model->lines[i].uid = 0;
+                model->lines[i].last_used = 0;
+                model->lines[i].scrollbar = false;
+            }
+            model->lines_tick = 0;
             model->rssi = -127.0f;
+            model->noise_floor = -127.0f;
+            model->rssi_threshold = -90.0f;
+            model->noise_floor_valid = false;
             model->external_radio = false;
             model->lock = ProtoPirateLockOff;
             model->lock_count = 0;
@@ -495,16 +607,14 @@ void protopirate_view_receiver_free(ProtoPirateReceiver* receiver) {
         receiver->view,
         ProtoPirateReceiverModel * model,
         {
-            for(size_t i = 0; i < ProtoPirateReceiverMenuItemArray_size(model->history_item_arr);
-                i++) {
-                ProtoPirateReceiverMenuItem* item =
-                    ProtoPirateReceiverMenuItemArray_get(model->history_item_arr, i);
-                furi_string_free(item->item_str);
-            }
             ProtoPirateReceiverMenuItemArray_clear(model->history_item_arr);
+            for(size_t i = 0; i < CACHE_LINES; i++) {
+                furi_string_free(model->lines[i].text);
+            }
             furi_string_free(model->frequency_str);
             furi_string_free(model->preset_str);
             furi_string_free(model->history_stat_str);
+            furi_string_free(model->hopper_stat_str);
         },
         false);
 
@@ -20,8 +20,15 @@ View* protopirate_view_receiver_get_view(ProtoPirateReceiver* receiver);
 void protopirate_view_receiver_add_item_to_menu(
     ProtoPirateReceiver* receiver,
     const char* name,
+    uint16_t bits,
     uint8_t type);
 
+// Empties the list, e.g. when the history is cleared
+void protopirate_view_receiver_reset_menu(ProtoPirateReceiver* receiver);
+
+// Drops the entry evicted from the history, later entries move up by one
+void protopirate_view_receiver_remove_item_from_menu(ProtoPirateReceiver* receiver, uint16_t idx);
+
 void protopirate_view_receiver_add_data_statusbar(
     ProtoPirateReceiver* receiver,
     const char* frequency_str,
@@ -32,4 +39,13 @@ void protopirate_view_receiver_add_data_statusbar(
 uint16_t protopirate_view_receiver_get_idx_menu(ProtoPirateReceiver* receiver);
 void protopirate_view_receiver_set_idx_menu(ProtoPirateReceiver* receiver, uint16_t idx);
 void protopirate_view_receiver_set_rssi(ProtoPirateReceiver* receiver, float rssi);
+// Noise floor readout left of the RSSI bars, the activity dot follows
+// threshold. valid false hides the readout.
+void protopirate_view_receiver_set_noise_floor(
+    ProtoPirateReceiver* receiver,
+    float level,
+    float threshold,
+    bool valid);
+// Short hopper readout shown next to "< Config" while the list is empty
+void protopirate_view_receiver_set_hopper_stat(ProtoPirateReceiver* receiver, const char* stat);
 void protopirate_view_receiver_set_lock(ProtoPirateReceiver* receiver, ProtoPirateLock lock);